@@ -0,0 +1,70 @@
+#include "cosave.h"
+#include "fake_serialization.h"
+
+namespace esas {
+namespace cosave {
+namespace {
+
+ShoutmapIR
+RandomIR(std::mt19937& rng, size_t n) {
+    auto ir = ShoutmapIR();
+    for (size_t i = 0; i < n; i++) {
+        ir.emplace_back(0x900 + static_cast<uint32_t>(i), static_cast<uint32_t>(rng()) | 1);
+    }
+    return ir;
+}
+
+}  // namespace
+
+TEST_CASE("cosave encode/decode", "[benchmark]") {
+    auto n = GENERATE(30u, 1000u, 5000u);
+    auto rng = std::mt19937(1);
+    auto ir = RandomIR(rng, n);
+    auto buf = std::vector<std::byte>();
+    EncodeShoutmapIR(ir, buf);
+    // Cosaves from before the binary format are still loaded.
+    auto json = Serialize(ir);
+
+    BENCHMARK(std::format("encode json, {} entries", n)) {
+        return Serialize(ir);
+    };
+    BENCHMARK(std::format("encode binary, {} entries", n)) {
+        EncodeShoutmapIR(ir, buf);
+        return buf.size();
+    };
+    BENCHMARK(std::format("decode json, {} entries", n)) {
+        return DecodeShoutmapIR(kVersionJson, std::as_bytes(std::span(json)));
+    };
+    BENCHMARK(std::format("decode binary, {} entries", n)) {
+        return DecodeShoutmapIR(kVersionBinary, buf);
+    };
+}
+
+TEST_CASE("cosave save/load", "[benchmark]") {
+    auto n = GENERATE(30u, 1000u, 5000u);
+    auto rng = std::mt19937(1);
+    auto ir = RandomIR(rng, n);
+    auto buf = std::vector<std::byte>();
+
+    auto si = FakeSerialization();
+    for (auto [_, spell_id] : ir) {
+        si.form_id_remap[spell_id] = spell_id;
+    }
+
+    BENCHMARK(std::format("save, {} entries", n)) {
+        si.records.clear();
+        si.Rewind();
+        return SaveShoutmapIR(si, ir, buf);
+    };
+
+    si.records.clear();
+    si.Rewind();
+    REQUIRE(SaveShoutmapIR(si, ir, buf));
+    BENCHMARK(std::format("load + resolve, {} entries", n)) {
+        si.Rewind();
+        return LoadShoutmapIR(si, buf);
+    };
+}
+
+}  // namespace cosave
+}  // namespace esas
@@ -0,0 +1,37 @@
+#include "form_index.h"
+
+namespace esas {
+
+TEST_CASE("FormIndex lookup", "[benchmark]") {
+    auto n = GENERATE(30u, 256u, 1024u, 4096u);
+    auto ids = std::vector<uint32_t>();
+    auto index = FormIndex(n);
+    for (uint32_t i = 0; i < n; i++) {
+        auto id = 0x0a000900 + i;
+        ids.push_back(id);
+        index.Insert(id, i);
+    }
+    // Probe slots spread evenly through the map, plus one miss.
+    auto probes = std::vector<uint32_t>();
+    for (uint32_t i = 0; i < 16; i++) {
+        probes.push_back(ids[i * n / 16]);
+    }
+    probes.push_back(0x0b000900);
+
+    BENCHMARK(std::format("linear find, {} slots", n)) {
+        size_t sum = 0;
+        for (auto id : probes) {
+            sum += std::find(ids.cbegin(), ids.cend(), id) - ids.cbegin();
+        }
+        return sum;
+    };
+    BENCHMARK(std::format("FormIndex, {} slots", n)) {
+        size_t sum = 0;
+        for (auto id : probes) {
+            sum += index.Find(id);
+        }
+        return sum;
+    };
+}
+
+}  // namespace esas
@@ -0,0 +1,44 @@
+#include "fs.h"
+#include "test_util.h"
+
+namespace esas {
+namespace {
+
+/// The previous `fs::ReadFile()`: stream into a string stream, then copy out.
+std::optional<std::string>
+ReadFileViaStringStream(std::string_view path) {
+    auto fp = fs::PathFromStr(path);
+    if (!fp) {
+        return std::nullopt;
+    }
+    auto f = std::ifstream(*fp);
+    if (!f.is_open()) {
+        return std::nullopt;
+    }
+    std::ostringstream ss;
+    ss << f.rdbuf();
+    return ss.str();
+}
+
+}  // namespace
+
+TEST_CASE("File reading", "[benchmark]") {
+    auto size = GENERATE(size_t(4) << 10, size_t(256) << 10, size_t(16) << 20);
+    auto td = Tempdir();
+    auto fp = td.path() + "/file.json";
+    REQUIRE(fs::WriteFile(fp, std::string(size, 'x')));
+    REQUIRE(ReadFileViaStringStream(fp)->size() == size);
+    REQUIRE(fs::FileContents::Read(fp)->size() == size);
+
+    BENCHMARK(std::format("ifstream -> ostringstream -> string, {} bytes", size)) {
+        return ReadFileViaStringStream(fp);
+    };
+    BENCHMARK(std::format("fs::ReadFile, {} bytes", size)) {
+        return fs::ReadFile(fp);
+    };
+    BENCHMARK(std::format("fs::FileContents::Read, {} bytes", size)) {
+        return fs::FileContents::Read(fp);
+    };
+}
+
+}  // namespace esas
@@ -0,0 +1,65 @@
+#include "input.h"
+#include "fake_input.h"
+
+namespace esas {
+
+TEST_CASE("Input dispatch", "[benchmark]") {
+    auto nevents = GENERATE(4u, 16u, 64u);
+    auto cm = FakeControlMap();
+    auto shout_key = [&](InputDevice device) { return cm.GetMappedKey("Shout", device); };
+    auto assign = Keysets(std::vector<Keyset>{{42, 13}, {54, 13}});
+    auto unassign = Keysets(std::vector<Keyset>{{42, 12}, {54, 12}});
+
+    auto events = std::vector<FakeEvent>();
+    auto rng = std::mt19937(1);
+    for (uint32_t i = 0; i < nevents; i++) {
+        events.push_back(Key(rng() % 80 + 2, static_cast<float>(rng() % 10) / 10.f));
+    }
+    events.back() = Key(44, .3f);  // shout button last, so the old scan walks the whole chain
+    auto chain = FakeEventChain(std::move(events));
+
+    // Previous behavior: each handler walks the chain separately.
+    auto buf = std::vector<Keystroke>();
+    BENCHMARK(std::format("two walks, {} events", nevents)) {
+        buf.clear();
+        for (const auto* ev = chain.head(); ev; ev = ev->next) {
+            const auto* b = ev->AsButtonEvent();
+            if (b && b->IsPressed()) {
+                auto keycode = KeycodeFromScancode(b->GetIDCode(), b->GetDevice());
+                auto ks = Keystroke::New(keycode, b->HeldDuration());
+                if (ks) {
+                    buf.push_back(*ks);
+                }
+            }
+        }
+        auto n = static_cast<int>(assign.Match(buf)) + static_cast<int>(unassign.Match(buf));
+
+        const FakeButton* shout = nullptr;
+        for (const auto* ev = chain.head(); ev && !shout; ev = ev->next) {
+            const auto* b = ev->AsButtonEvent();
+            if (b && cm.GetMappedKey("Shout", b->GetDevice()) == b->GetIDCode()) {
+                shout = b;
+            }
+        }
+        return n + (shout && !shout->IsUp());
+    };
+
+    auto frame = InputFrame();
+    BENCHMARK(std::format("single-pass dispatcher, {} events", nevents)) {
+        InputFrame::Decode(chain.head(), shout_key, frame);
+        auto n = static_cast<int>(assign.Match(frame.keystrokes()))
+                 + static_cast<int>(unassign.Match(frame.keystrokes()));
+        return n + (frame.shout_button() == ShoutButton::kDown);
+    };
+
+    auto cache = MappedKeyCache("Shout");
+    auto cached_shout_key = [&](InputDevice device) { return cache.Get(cm, device); };
+    BENCHMARK(std::format("single-pass dispatcher, cached mapping, {} events", nevents)) {
+        InputFrame::Decode(chain.head(), cached_shout_key, frame);
+        auto n = static_cast<int>(assign.Match(frame.keystrokes()))
+                 + static_cast<int>(unassign.Match(frame.keystrokes()));
+        return n + (frame.shout_button() == ShoutButton::kDown);
+    };
+}
+
+}  // namespace esas
@@ -0,0 +1,65 @@
+#include "keys.h"
+#include "random_keys.h"
+#include "reference_keys.h"
+
+namespace esas {
+
+TEST_CASE("Keysets match", "[benchmark]") {
+    auto nkeysets = GENERATE(2u, 16u, 256u, 1024u);
+    auto nkeystrokes = GENERATE(1u, 4u, 16u, 128u);
+    auto rng = std::mt19937(1);
+    // Keyboard, mouse and gamepad keycodes all mixed together.
+    auto pool = ValidKeycodes();
+    auto keysets = RandomKeysets(rng, pool, nkeysets);
+    auto keystrokes = RandomKeystrokes(rng, pool, nkeystrokes);
+    auto frame = KeystrokeFrame();
+
+    BENCHMARK(std::format("linear, {} keysets, {} keystrokes", nkeysets, nkeystrokes)) {
+        return MatchLinear(keysets, keystrokes);
+    };
+    BENCHMARK(std::format("fold + match, {} keysets, {} keystrokes", nkeysets, nkeystrokes)) {
+        frame.Fold(keystrokes);
+        return keysets.Match(frame);
+    };
+}
+
+TEST_CASE("Keycode names", "[benchmark]") {
+    auto keycodes = ValidKeycodes();
+    // Every valid name plus as many misses, as when loading a settings file with typos.
+    auto names = std::vector<std::string>();
+    for (auto keycode : keycodes) {
+        names.emplace_back(KeycodeName(keycode));
+        names.push_back(std::string(KeycodeName(keycode)) + "?");
+    }
+
+    BENCHMARK(std::format("linear scan, {} names", names.size())) {
+        auto sum = uint32_t(0);
+        for (const auto& name : names) {
+            sum += KeycodeFromNameLinear(name);
+        }
+        return sum;
+    };
+    BENCHMARK(std::format("KeycodeFromName, {} names", names.size())) {
+        auto sum = uint32_t(0);
+        for (const auto& name : names) {
+            sum += KeycodeFromName(name);
+        }
+        return sum;
+    };
+    BENCHMARK(std::format("KeycodeFromNameLoose, {} names", names.size())) {
+        auto sum = uint32_t(0);
+        for (const auto& name : names) {
+            sum += KeycodeFromNameLoose(name);
+        }
+        return sum;
+    };
+    BENCHMARK("KeycodeName, all keycodes") {
+        auto sum = size_t(0);
+        for (auto keycode : keycodes) {
+            sum += KeycodeName(keycode).size();
+        }
+        return sum;
+    };
+}
+
+}  // namespace esas
@@ -0,0 +1,109 @@
+#include "fake_forms.h"
+#include "logging.h"
+#include "shout_slots.h"
+#include "test_util.h"
+
+namespace esas {
+namespace {
+
+/// Stands in for the rest of a frame's work, so the async logger's worker thread can keep up as
+/// it would in game, where the cast path logs a few messages per frame at most.
+void
+OtherWork() {
+    auto end = std::chrono::steady_clock::now() + 20us;
+    while (std::chrono::steady_clock::now() < end) {}
+}
+
+}  // namespace
+
+// Mirrors `InitLogging()`: every message is flushed. Subtract the "no logging" time to get the
+// game thread's cost per message.
+TEST_CASE("File logging", "[benchmark]") {
+    auto tempdir = Tempdir();
+    auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(tempdir.path() + "/log", true);
+    auto pool = std::make_shared<spdlog::details::thread_pool>(8192, 1);
+
+    BENCHMARK("no logging") {
+        OtherWork();
+    };
+
+    auto sync_logger = spdlog::logger("sync", sink);
+    sync_logger.set_level(spdlog::level::debug);
+    sync_logger.flush_on(spdlog::level::debug);
+    BENCHMARK("sync") {
+        sync_logger.debug("faf: casting {:08X} -> {:08X}", 0x2f7bbu, 0x12fcdu);
+        OtherWork();
+    };
+
+    auto async_logger = spdlog::async_logger(
+        "async", sink, pool, spdlog::async_overflow_policy::overrun_oldest
+    );
+    async_logger.set_level(spdlog::level::debug);
+    async_logger.flush_on(spdlog::level::debug);
+    BENCHMARK("async") {
+        async_logger.debug("faf: casting {:08X} -> {:08X}", 0x2f7bbu, 0x12fcdu);
+        OtherWork();
+    };
+    async_logger.flush();
+}
+
+// Mirrors the cast handlers' lookup, which traces misses and logs hits at debug level. The default
+// logger filters both at runtime. The "as built" case depends on `ESAS_ACTIVE_LOG_LEVEL`; compare
+// against the perf preset.
+TEST_CASE("Verbose logging on the lookup path", "[benchmark]") {
+    REQUIRE(!spdlog::default_logger_raw()->should_log(spdlog::level::debug));
+
+    auto shouts = FakeForms<FakeShout>(0x900, 30);
+    auto spells = FakeForms<FakeSpell>(0x1000, 30);
+    auto slots = ShoutSlots<FakeShout, FakeSpell>(shouts.ptrs());
+    for (size_t i = 0; i < 30; i += 2) {
+        slots.Set(i, &spells[i]);
+    }
+
+    BENCHMARK("no logging") {
+        auto found = size_t(0);
+        for (size_t i = 0; i < 1024; i++) {
+            const auto& shout = shouts[i % 30];
+            auto* spell = slots.spells()[slots.IndexOf(shout)];
+            found += spell != nullptr;
+        }
+        return found;
+    };
+
+    BENCHMARK("runtime-filtered logging") {
+        auto found = size_t(0);
+        for (size_t i = 0; i < 1024; i++) {
+            const auto& shout = shouts[i % 30];
+            auto* spell = slots.spells()[slots.IndexOf(shout)];
+            if (!spell) {
+                ESAS_LOG_CALL(spdlog::level::trace, "{:08X} is unassigned", shout.GetFormID());
+                continue;
+            }
+            ESAS_LOG_CALL(
+                spdlog::level::debug,
+                "casting {:08X} -> {:08X}",
+                shout.GetFormID(),
+                spell->GetFormID()
+            );
+            found++;
+        }
+        return found;
+    };
+
+    BENCHMARK("logging macros as built") {
+        auto found = size_t(0);
+        for (size_t i = 0; i < 1024; i++) {
+            const auto& shout = shouts[i % 30];
+            auto* spell = slots.spells()[slots.IndexOf(shout)];
+            if (!spell) {
+                ESAS_LOG_TRACE("{:08X} is unassigned", shout.GetFormID());
+                continue;
+            }
+            ESAS_LOG_DEBUG("casting {:08X} -> {:08X}", shout.GetFormID(), spell->GetFormID());
+            found++;
+        }
+        return found;
+    };
+}
+
+}  // namespace esas
@@ -0,0 +1,31 @@
+#include "metrics.h"
+
+namespace esas {
+namespace metrics {
+
+TEST_CASE("Metrics overhead", "[benchmark]") {
+    auto r = Registry();
+    auto x = uint64_t(0);
+    auto work = [&x]() { x = x * 6364136223846793005 + 1442695040888963407; };
+
+    BENCHMARK("uninstrumented") {
+        work();
+        return x;
+    };
+
+    BENCHMARK("disabled") {
+        r.Time(Probe::kFafAction, work);
+        r.Count(Counter::kLookups);
+        return x;
+    };
+
+    r.SetEnabled(true);
+    BENCHMARK("enabled") {
+        r.Time(Probe::kFafAction, work);
+        r.Count(Counter::kLookups);
+        return x;
+    };
+}
+
+}  // namespace metrics
+}  // namespace esas
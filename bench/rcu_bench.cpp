@@ -0,0 +1,33 @@
+#include "rcu.h"
+#include "rcu_slots.h"
+
+namespace esas {
+
+TEST_CASE("Rcu reader latency under writer churn", "[benchmark]") {
+    auto nreaders = GENERATE(1u, 2u, 4u, 8u);
+    auto rcu = Rcu<Slots>();
+    auto stats = Hammer(rcu, nreaders, 200000, /*record_latency=*/true);
+
+    auto all = std::vector<uint32_t>();
+    for (const auto& st : stats) {
+        REQUIRE(st.torn == 0);
+        all.insert(all.end(), st.latencies_ns.cbegin(), st.latencies_ns.cend());
+    }
+    REQUIRE(!all.empty());
+    std::sort(all.begin(), all.end());
+    auto pct = [&](double p) {
+        return all[std::min(all.size() - 1, static_cast<size_t>(p * all.size()))];
+    };
+    WARN(std::format(
+        "{} readers, {} reads: p50={}ns p90={}ns p99={}ns p99.9={}ns max={}ns",
+        nreaders,
+        all.size(),
+        pct(.5),
+        pct(.9),
+        pct(.99),
+        pct(.999),
+        all.back()
+    ));
+}
+
+}  // namespace esas
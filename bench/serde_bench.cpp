@@ -0,0 +1,90 @@
+#include "serde.h"
+#include "random_keys.h"
+#include "settings_parser.h"
+
+namespace esas {
+namespace {
+
+/// A settings file with `nkeysets` keysets per keyset field, commented like the shipped one.
+///
+/// Also has `nspells` per-spell entries under a field that settings don't (yet) understand, which
+/// parsers must skip.
+std::string
+SettingsJson(size_t nkeysets, size_t nspells = 0) {
+    auto rng = std::mt19937(1);
+    auto pool = ValidKeycodes();
+    auto keysets_json = [&]() {
+        auto s = std::string("[\n");
+        for (const auto& keyset : RandomKeysets(rng, pool, nkeysets).vec()) {
+            s += "        " + Serialize(keyset) + ",\n";
+        }
+        return s + "    ]";
+    };
+    auto spells_json = std::string("[\n");
+    for (size_t i = 0; i < nspells; i++) {
+        spells_json += std::format(
+            R"(        {{"spell": ["Skyrim.esm", {}], "magicka_scale": 0.75, )"
+            R"("keys": ["LShift", "{}"]}},)"
+            "\n",
+            0x12fcd + i,
+            i % 10
+        );
+    }
+    spells_json += "    ]";
+    return std::format(
+        R"({{
+    // info (default)
+    "log_level": "info",
+    // Default: Shift + Equals Sign
+    "convert_spell_keysets": {},
+    // Default: Shift + Minus Sign
+    "remove_shout_keysets": {},
+    "allow_2h_spells": false,
+    "magicka_scale_faf": 1.0,
+    "magicka_scale_conc": 1.0,
+    "spell_overrides": {},
+}})",
+        keysets_json(),
+        keysets_json(),
+        spells_json
+    );
+}
+
+}  // namespace
+
+TEST_CASE("Settings deserialize", "[benchmark]") {
+    auto nkeysets = GENERATE(2u, 64u, 1024u);
+    auto json = SettingsJson(nkeysets);
+    REQUIRE(Deserialize<Settings>(json));
+
+    BENCHMARK(std::format("Deserialize<Settings>, {} keysets per field", nkeysets)) {
+        return Deserialize<Settings>(json);
+    };
+}
+
+TEST_CASE("Settings DOM vs streaming parse", "[benchmark]") {
+    auto [nkeysets, nspells] = GENERATE(
+        std::pair<size_t, size_t>{2, 0},
+        std::pair<size_t, size_t>{1024, 0},
+        std::pair<size_t, size_t>{4096, 0},
+        std::pair<size_t, size_t>{2, 4096},
+        std::pair<size_t, size_t>{4096, 4096}
+    );
+    auto json = SettingsJson(nkeysets, nspells);
+    auto dom = Deserialize<Settings>(json);
+    auto sax = ParseSettings(json);
+    REQUIRE(dom);
+    REQUIRE(sax);
+    REQUIRE(sax->convert_spell_keysets.vec() == dom->convert_spell_keysets.vec());
+    REQUIRE(sax->remove_shout_keysets.vec() == dom->remove_shout_keysets.vec());
+
+    auto label = std::format("{} keysets per field, {} spell entries", nkeysets, nspells);
+    BENCHMARK("Deserialize<Settings>, " + label) {
+        return Deserialize<Settings>(json);
+    };
+    BENCHMARK("ParseSettings, " + label) {
+        return ParseSettings(json);
+    };
+}
+
+}  // namespace esas
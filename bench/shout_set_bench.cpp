@@ -0,0 +1,43 @@
+#include "fake_forms.h"
+#include "shout_set.h"
+#include "shout_slots.h"
+
+namespace esas {
+
+// Mirrors `ShoutmapToIR()`: for every assigned slot, check that the player has the shout. The
+// player's shouts are a flat, unsorted list, like the game stores them, and include shouts from
+// other sources.
+TEST_CASE("Player shout checks on save", "[benchmark]") {
+    auto n = GENERATE(30u, 256u, 512u);
+    auto shouts = FakeForms<FakeShout>(0x900, n);
+    auto others = FakeForms<FakeShout>(0x100000, 100);
+    auto spells = FakeForms<FakeSpell>(0x200000, n);
+    auto slots = ShoutSlots<FakeShout, FakeSpell>(shouts.ptrs());
+    auto owned = others.ptrs();
+    for (size_t i = 0; i < n; i++) {
+        slots.Set(i, &spells[i]);
+        owned.push_back(&shouts[i]);
+    }
+    std::ranges::shuffle(owned, std::mt19937(1));
+
+    auto count_owned = [&](auto has_shout) {
+        auto count = size_t(0);
+        for (size_t i = 0; i < slots.size(); i++) {
+            count += slots.spells()[i] && has_shout(slots.shouts()[i]);
+        }
+        return count;
+    };
+
+    BENCHMARK(std::format("scan shout list per slot, {} slots", n)) {
+        return count_owned([&](const FakeShout* shout) {
+            return std::ranges::find(owned, shout) != owned.end();
+        });
+    };
+
+    BENCHMARK(std::format("snapshot shout list once, {} slots", n)) {
+        auto set = ShoutSet(owned);
+        return count_owned([&](const FakeShout* shout) { return set.HasShout(shout); });
+    };
+}
+
+}  // namespace esas
@@ -0,0 +1,84 @@
+#include "shout_slots.h"
+#include "fake_forms.h"
+#include "rcu.h"
+
+namespace esas {
+namespace {
+
+using FakeSlots = ShoutSlots<FakeShout, FakeSpell>;
+
+}  // namespace
+
+TEST_CASE("ShoutSlots lookup", "[benchmark]") {
+    // 30 is the number of shouts in the mod's plugin.
+    auto n = GENERATE(30u, 256u, 1024u);
+    auto shouts = FakeForms<FakeShout>(0x900, n);
+    auto spells = FakeForms<FakeSpell>(0x1000, n * 2);
+    auto slots = FakeSlots(shouts.ptrs());
+    for (size_t i = 0; i < n; i++) {
+        slots.Set(i, &spells[i]);
+    }
+
+    // Half hits, half misses.
+    auto rng = std::mt19937(1);
+    auto queries = std::vector<const FakeSpell*>();
+    for (size_t i = 0; i < 1024; i++) {
+        queries.push_back(&spells[rng() % (n * 2)]);
+    }
+
+    BENCHMARK(std::format("shout lookup, {} slots, 1024 queries", n)) {
+        auto found = size_t(0);
+        for (size_t i = 0; i < 1024; i++) {
+            found += slots.IndexOf(shouts[i % n]) < slots.size();
+        }
+        return found;
+    };
+    BENCHMARK(std::format("spell lookup, {} slots, 1024 queries", n)) {
+        auto found = size_t(0);
+        for (const auto* spell : queries) {
+            found += slots.IndexOf(*spell) < slots.size();
+        }
+        return found;
+    };
+
+    auto snapshot = Rcu<FakeSlots>(std::make_unique<const FakeSlots>(slots));
+    BENCHMARK(std::format("snapshot read + spell lookup, {} slots, 1024 queries", n)) {
+        auto found = size_t(0);
+        for (const auto* spell : queries) {
+            auto map = snapshot.Read();
+            found += map->IndexOf(*spell) < map->size();
+        }
+        return found;
+    };
+}
+
+TEST_CASE("ShoutSlots assignment churn", "[benchmark]") {
+    auto n = GENERATE(30u, 256u, 1024u);
+    auto shouts = FakeForms<FakeShout>(0x900, n);
+    auto spells = FakeForms<FakeSpell>(0x1000, n * 2);
+    auto slots = FakeSlots(shouts.ptrs());
+
+    // Like a player cycling through spells: assign into the next free slot, and unassign a random
+    // slot when out of slots (or every so often anyway).
+    auto rng = std::mt19937(1);
+    BENCHMARK(std::format("assign/unassign, {} slots, 1024 ops", n)) {
+        for (size_t op = 0; op < 1024; op++) {
+            auto* spell = &spells[rng() % (n * 2)];
+            if (slots.IndexOf(*spell) < slots.size()) {
+                continue;
+            }
+            auto i = slots.NextUnassigned();
+            if (i >= slots.size() || rng() % 8 == 0) {
+                auto j = rng() % n;
+                slots.Set(j, nullptr);
+                slots.SetOwned(j, false);
+                continue;
+            }
+            slots.Set(i, spell);
+            slots.SetOwned(i, true);
+        }
+        return slots.size();
+    };
+}
+
+}  // namespace esas
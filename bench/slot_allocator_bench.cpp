@@ -0,0 +1,48 @@
+#include "fake_forms.h"
+#include "shout_slots.h"
+
+namespace esas {
+
+// Picking a slot for a new assignment when nearly all slots are taken. The old approach scanned
+// every slot, asking the player about each shout; the player here has as many shouts as there are
+// slots, stored as a flat list like the game stores them.
+TEST_CASE("Next unassigned slot", "[benchmark]") {
+    auto n = GENERATE(30u, 512u, 4096u);
+    auto shouts = FakeForms<FakeShout>(0x900, n);
+    auto spells = FakeForms<FakeSpell>(0x100000, n);
+    auto slots = ShoutSlots<FakeShout, FakeSpell>(shouts.ptrs());
+    auto owned = std::vector<const FakeShout*>();
+    for (size_t i = 0; i + 1 < n; i++) {
+        slots.Set(i, &spells[i]);
+        owned.push_back(&shouts[i]);
+    }
+    slots.RefreshOwned(owned);
+    auto has_shout = [&](const FakeShout* shout) {
+        return std::ranges::find(owned, shout) != owned.end();
+    };
+
+    BENCHMARK(std::format("linear scan with per-shout inventory lookup, {} slots", n)) {
+        for (size_t i = 0; i < slots.size(); i++) {
+            if (slots.spells()[i] && !has_shout(slots.shouts()[i])) {
+                return i;
+            }
+        }
+        for (size_t i = 0; i < slots.size(); i++) {
+            if (!slots.spells()[i]) {
+                return i;
+            }
+        }
+        return slots.size();
+    };
+
+    BENCHMARK(std::format("allocator, {} slots", n)) {
+        return slots.NextUnassigned();
+    };
+
+    BENCHMARK(std::format("refresh ownership + allocator, {} slots", n)) {
+        slots.RefreshOwned(owned);
+        return slots.NextUnassigned();
+    };
+}
+
+}  // namespace esas
@@ -0,0 +1,28 @@
+// Minimal interfaces that game-agnostic code needs from game types. CommonLibSSE's types satisfy
+// them as is, and tests satisfy them with plain structs.
+//
+// Cosave I/O has its own interface, `SerializationApi` in record_stream.h.
+#pragma once
+
+namespace esas {
+
+/// Satisfied by `RE::TESForm` and its subclasses.
+template <typename T>
+concept FormLike = requires(const T& form) {
+    { form.GetFormID() } -> std::convertible_to<uint32_t>;
+};
+
+/// Satisfied by `RE::Actor` for `Shout = RE::TESShout`.
+template <typename A, typename Shout>
+concept ShoutHolder = requires(const A& actor, Shout* shout) {
+    { actor.HasShout(shout) } -> std::convertible_to<bool>;
+};
+
+/// Compiles and runs one console command, returning false if it couldn't be run at all. Satisfied
+/// by `tes_util::ConsoleScript`.
+template <typename E>
+concept ConsoleExecutor = requires(E& executor, const std::string& cmd) {
+    { executor.Run(cmd) } -> std::convertible_to<bool>;
+};
+
+}  // namespace esas
@@ -0,0 +1,83 @@
+// Per-spell data that the casting path needs, computed once per assignment.
+#pragma once
+
+namespace esas {
+
+/// Mirrors `RE::MagicSystem::CastingType`.
+enum class CastingType : uint8_t {
+    kConstantEffect = 0,
+    kFireAndForget = 1,
+    kConcentration = 2,
+    kScroll = 3,
+};
+
+/// Everything about an assigned spell that the casting path reads, so that firing a shout doesn't
+/// have to walk the spell's effects or sound list. Built from the spell when it's assigned to a
+/// slot, and discarded when the slot gets a different spell.
+///
+/// `Sound` is `RE::BGSSoundDescriptorForm` in game.
+template <typename Sound>
+struct CastProfile final {
+    CastingType casting_type = CastingType::kConstantEffect;
+    /// Whether the spell's primary effect summons a bound weapon. Such spells must be cast from a
+    /// hand.
+    bool bound_weapon = false;
+    /// May be null.
+    const Sound* release_sound = nullptr;
+    /// Played for as long as a concentration spell is cast. May be null.
+    const Sound* loop_sound = nullptr;
+
+    bool operator==(const CastProfile&) const = default;
+};
+
+/// Mirrors the `RE::MagicSystem::SoundID` values that profiles use.
+enum class CastSoundID : uint32_t {
+    kRelease = 3,
+    kCastLoop = 4,
+};
+
+/// What `MakeCastProfile()` reads from a spell. `tes_util::SpellProfileSource` adapts
+/// `RE::SpellItem`.
+///
+/// - `casting_type()`: the spell's `RE::MagicSystem::CastingType`, as an integer.
+/// - `bound_weapon()`: whether the spell's primary effect has the bound weapon archetype.
+/// - `effect_sounds()`: the primary effect's sounds, as elements with an `id` (convertible to
+///   `CastSoundID`) and a `sound` (may be null). Empty if the spell has no primary effect.
+template <typename S, typename Sound>
+concept CastProfileSource = requires(const S& spell) {
+    { spell.casting_type() } -> std::convertible_to<uint32_t>;
+    { spell.bound_weapon() } -> std::convertible_to<bool>;
+    { spell.effect_sounds() } -> std::ranges::input_range;
+    {
+        static_cast<CastSoundID>(std::ranges::begin(spell.effect_sounds())->id)
+    } -> std::same_as<CastSoundID>;
+    { std::ranges::begin(spell.effect_sounds())->sound } -> std::convertible_to<const Sound*>;
+};
+
+/// Builds the profile for `spell`. Casting types outside `CastingType` become `kConstantEffect`,
+/// which the casting path never casts. Each sound is the first non-null one with its ID.
+template <typename Sound, CastProfileSource<Sound> S>
+CastProfile<Sound>
+MakeCastProfile(const S& spell) {
+    auto profile = CastProfile<Sound>();
+    auto ct = static_cast<uint32_t>(spell.casting_type());
+    if (ct <= std::to_underlying(CastingType::kScroll)) {
+        profile.casting_type = static_cast<CastingType>(ct);
+    }
+    profile.bound_weapon = spell.bound_weapon();
+    for (const auto& soundpair : spell.effect_sounds()) {
+        const Sound* sound = soundpair.sound;
+        if (!sound) {
+            continue;
+        }
+        auto id = static_cast<CastSoundID>(soundpair.id);
+        if (id == CastSoundID::kRelease && !profile.release_sound) {
+            profile.release_sound = sound;
+        } else if (id == CastSoundID::kCastLoop && !profile.loop_sound) {
+            profile.loop_sound = sound;
+        }
+    }
+    return profile;
+}
+
+}  // namespace esas
@@ -0,0 +1,79 @@
+// Deferred console commands.
+#pragma once
+
+#include "adapters.h"
+
+namespace esas {
+
+/// Console commands queued during a frame, to be run together at the end of it.
+///
+/// Queued commands are coalesced: each word is taught at most once and each shout is removed at
+/// most once per flush. On flush, all `teachword`s run before all `removeshout`s, because teaching
+/// a word adds a shout that then has to be removed.
+class ConsoleBatch final {
+  public:
+    bool
+    empty() const {
+        return teach_words_.empty() && remove_shouts_.empty();
+    }
+
+    /// Queues `player.teachword`.
+    void
+    TeachWord(uint32_t word_id) {
+        PushUnique(teach_words_, word_id);
+    }
+
+    /// Queues `player.removeshout`.
+    void
+    RemoveShout(uint32_t shout_id) {
+        PushUnique(remove_shouts_, shout_id);
+    }
+
+    /// Dequeues `player.removeshout` for `shout_id`, if queued. Call after giving the shout back to
+    /// the player, so that the pending removal doesn't undo that.
+    void
+    CancelRemoveShout(uint32_t shout_id) {
+        std::erase(remove_shouts_, shout_id);
+    }
+
+    /// Runs and dequeues all queued commands. Returns the number of commands that `executor`
+    /// failed to run.
+    template <ConsoleExecutor E>
+    size_t
+    Flush(E& executor) {
+        auto failures = size_t(0);
+        for (auto id : teach_words_) {
+            failures += !Run(executor, "player.teachword", id);
+        }
+        for (auto id : remove_shouts_) {
+            failures += !Run(executor, "player.removeshout", id);
+        }
+        teach_words_.clear();
+        remove_shouts_.clear();
+        return failures;
+    }
+
+  private:
+    /// At most a handful of commands are queued per frame, so a linear scan beats hashing.
+    static void
+    PushUnique(std::vector<uint32_t>& v, uint32_t id) {
+        if (std::ranges::find(v, id) == v.end()) {
+            v.push_back(id);
+        }
+    }
+
+    template <ConsoleExecutor E>
+    bool
+    Run(E& executor, std::string_view verb, uint32_t id) {
+        cmd_.clear();
+        std::format_to(std::back_inserter(cmd_), "{} {:08x}", verb, id);
+        return executor.Run(cmd_);
+    }
+
+    std::vector<uint32_t> teach_words_;
+    std::vector<uint32_t> remove_shouts_;
+    /// Reused across commands to avoid allocating.
+    std::string cmd_;
+};
+
+}  // namespace esas
@@ -0,0 +1,171 @@
+// SKSE cosave record format.
+#pragma once
+
+#include "record_stream.h"
+#include "serde.h"
+
+namespace esas {
+
+/// Maps spell shout local IDs (or, for dynamic shouts, tagged indices; see shoutmap.h) to spell
+/// absolute IDs.
+using ShoutmapIR = std::vector<std::pair<uint32_t, uint32_t>>;
+
+namespace cosave {
+namespace internal {
+
+inline constexpr auto kCrc32Table = []() {
+    auto table = std::array<uint32_t, 256>();
+    for (uint32_t i = 0; i < table.size(); i++) {
+        auto c = i;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? 0xedb88320 ^ (c >> 1) : c >> 1;
+        }
+        table[i] = c;
+    }
+    return table;
+}();
+
+inline void
+PutU32(std::byte* p, uint32_t v) {
+    p[0] = static_cast<std::byte>(v);
+    p[1] = static_cast<std::byte>(v >> 8);
+    p[2] = static_cast<std::byte>(v >> 16);
+    p[3] = static_cast<std::byte>(v >> 24);
+}
+
+inline uint32_t
+GetU32(const std::byte* p) {
+    return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8
+           | static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+}
+
+}  // namespace internal
+
+inline constexpr uint32_t kRecordType = RecordType("ESAS");
+
+/// Shoutmap IR serialized as a JSON array of `[shout local ID, spell ID]` pairs. Only read, for
+/// migrating saves made before `kVersionBinary`.
+inline constexpr uint32_t kVersionJson = 1;
+
+/// Shoutmap IR serialized as:
+/// - u32: number of pairs
+/// - u32: CRC-32 of the pairs
+/// - (u32 shout local ID, u32 spell ID) for each pair
+///
+/// All integers are little-endian.
+inline constexpr uint32_t kVersionBinary = 2;
+
+inline constexpr size_t kBinaryHeaderSize = 8;
+inline constexpr size_t kBinaryPairSize = 8;
+
+/// CRC-32 (IEEE 802.3).
+inline uint32_t
+Crc32(std::span<const std::byte> data) {
+    auto c = ~uint32_t(0);
+    for (auto b : data) {
+        c = internal::kCrc32Table[(c ^ static_cast<uint32_t>(b)) & 0xff] ^ (c >> 8);
+    }
+    return ~c;
+}
+
+/// Encodes `ir` as a `kVersionBinary` record into `buf`, replacing its previous contents. `buf` is
+/// taken by reference so that callers can reuse its allocation.
+inline void
+EncodeShoutmapIR(const ShoutmapIR& ir, std::vector<std::byte>& buf) {
+    buf.resize(kBinaryHeaderSize + ir.size() * kBinaryPairSize);
+    auto* p = buf.data() + kBinaryHeaderSize;
+    for (const auto& [shout_local_id, spell_id] : ir) {
+        internal::PutU32(p, shout_local_id);
+        internal::PutU32(p + 4, spell_id);
+        p += kBinaryPairSize;
+    }
+    internal::PutU32(buf.data(), static_cast<uint32_t>(ir.size()));
+    internal::PutU32(buf.data() + 4, Crc32(std::span(buf).subspan(kBinaryHeaderSize)));
+}
+
+/// Decodes a record of the given version. Returns nullopt if the version is unknown or `data` is
+/// malformed (wrong length, bad checksum, invalid JSON).
+inline std::optional<ShoutmapIR>
+DecodeShoutmapIR(uint32_t version, std::span<const std::byte> data) {
+    switch (version) {
+        case kVersionJson:
+            return Deserialize<ShoutmapIR>(
+                std::string_view(reinterpret_cast<const char*>(data.data()), data.size())
+            );
+        case kVersionBinary:
+            break;
+        default:
+            return std::nullopt;
+    }
+
+    if (data.size() < kBinaryHeaderSize) {
+        return std::nullopt;
+    }
+    auto count = internal::GetU32(data.data());
+    auto pairs = data.subspan(kBinaryHeaderSize);
+    if (pairs.size() / kBinaryPairSize != count || pairs.size() % kBinaryPairSize != 0) {
+        return std::nullopt;
+    }
+    if (internal::GetU32(data.data() + 4) != Crc32(pairs)) {
+        return std::nullopt;
+    }
+
+    auto ir = ShoutmapIR();
+    ir.reserve(count);
+    for (const auto* p = pairs.data(); p != pairs.data() + pairs.size(); p += kBinaryPairSize) {
+        ir.emplace_back(internal::GetU32(p), internal::GetU32(p + 4));
+    }
+    return ir;
+}
+
+/// Writes `ir` as a single `kRecordType` record. `buf` is scratch space, taken by reference so that
+/// callers can reuse its allocation.
+template <SerializationApi SI>
+bool
+SaveShoutmapIR(const SI& si, const ShoutmapIR& ir, std::vector<std::byte>& buf) {
+    EncodeShoutmapIR(ir, buf);
+    auto w = RecordWriter(si, kRecordType, kVersionBinary);
+    return w.Write(buf);
+}
+
+/// Reads all remaining records in the cosave, returning the concatenation of every decodable
+/// `kRecordType` record. Spell IDs are resolved to the current load order; pairs whose spell no
+/// longer exists are dropped.
+template <SerializationApi SI>
+ShoutmapIR
+LoadShoutmapIR(const SI& si, std::vector<std::byte>& buf) {
+    auto ir = ShoutmapIR();
+    uint32_t type;
+    uint32_t version;
+    uint32_t length;
+    while (si.GetNextRecordInfo(type, version, length)) {
+        if (type != kRecordType) {
+            spdlog::warn("unknown record type '{}' in SKSE cosave", type);
+            continue;
+        }
+
+        auto data = RecordReader(si, length, buf).ReadAll();
+        if (!data) {
+            spdlog::error("cannot read spell shout assignments from SKSE cosave");
+            continue;
+        }
+        auto record_ir = DecodeShoutmapIR(version, *data);
+        if (!record_ir) {
+            spdlog::error("cannot deserialize spell shout assignments from SKSE cosave");
+            continue;
+        }
+
+        for (auto [shout_local_id, spell_id] : *record_ir) {
+            auto new_spell_id = uint32_t(0);
+            if (!si.ResolveFormID(spell_id, new_spell_id) || new_spell_id == 0) {
+                spdlog::warn("cannot resolve old form ID {:08X}", spell_id);
+                continue;
+            }
+            ir.emplace_back(shout_local_id, new_spell_id);
+        }
+    }
+    return ir;
+}
+
+}  // namespace cosave
+}  // namespace esas
@@ -1,73 +1,134 @@
 #pragma once
 
+#include "forms.h"
+#include "input.h"
 #include "keys.h"
+#include "logging.h"
+#include "metrics.h"
+#include "rcu.h"
 #include "settings.h"
 #include "shoutmap.h"
 #include "tes_util.h"
 
 namespace esas {
-namespace internal {
-
-/// Among the given input events, find a button event that matches `user_event`. `user_event` should
-/// be a member of `RE::UserEvents`.
-inline const RE::ButtonEvent*
-GetUserEventButtonInput(std::string_view user_event, const RE::InputEvent* events) {
-    const auto* cm = RE::ControlMap::GetSingleton();
-    if (!cm) {
-        return nullptr;
+
+static_assert(
+    std::to_underlying(InputDevice::kKeyboard) == std::to_underlying(RE::INPUT_DEVICE::kKeyboard)
+);
+static_assert(
+    std::to_underlying(InputDevice::kMouse) == std::to_underlying(RE::INPUT_DEVICE::kMouse)
+);
+static_assert(
+    std::to_underlying(InputDevice::kGamepad) == std::to_underlying(RE::INPUT_DEVICE::kGamepad)
+);
+static_assert(kMouseKeycodeOffset == SKSE::InputMap::kMacro_MouseButtonOffset);
+static_assert(kGamepadKeycodeOffset == SKSE::InputMap::kMacro_GamepadOffset);
+
+/// The plugin's only input event sink. Walks each frame's event chain exactly once, then fans the
+/// decoded frame out to subscribers in subscription order.
+///
+/// Also listens for menu close events to invalidate its cached shout button mapping, since controls
+/// can only be remapped from within menus.
+class InputDispatcher final : public RE::BSTEventSink<RE::InputEvent*>,
+                              public RE::BSTEventSink<RE::MenuOpenCloseEvent> {
+  public:
+    /// Returns null on failure.
+    [[nodiscard]] static InputDispatcher*
+    Init() {
+        auto* input_ev_src = RE::BSInputDeviceManager::GetSingleton();
+        auto* ui = RE::UI::GetSingleton();
+        const auto* user_events = RE::UserEvents::GetSingleton();
+        if (!input_ev_src || !ui || !user_events) {
+            return nullptr;
+        }
+
+        static auto instance = InputDispatcher(user_events->shout);
+        input_ev_src->AddEventSink(&instance);
+        ui->AddEventSink<RE::MenuOpenCloseEvent>(&instance);
+        return &instance;
+    }
+
+    void
+    Subscribe(InputSubscriber& subscriber) {
+        subscribers_.push_back(&subscriber);
+    }
+
+    /// Call whenever controls may have been remapped outside of a menu, e.g. on loading a game.
+    void
+    InvalidateControlMap() {
+        shout_key_.Invalidate();
     }
 
-    for (; events; events = events->next) {
-        const auto* button = events->AsButtonEvent();
-        if (!button || !button->HasIDCode()) {
-            continue;
+    RE::BSEventNotifyControl
+    ProcessEvent(RE::InputEvent* const* events, RE::BSTEventSource<RE::InputEvent*>*) override {
+        if (subscribers_.empty()) {
+            return RE::BSEventNotifyControl::kContinue;
         }
-        if (cm->GetMappedKey(user_event, button->GetDevice()) != button->GetIDCode()) {
-            continue;
+
+        metrics::gRegistry.Time(metrics::Probe::kInputDispatch, [&] {
+            const auto* cm = RE::ControlMap::GetSingleton();
+            auto shout_key = [&](RE::INPUT_DEVICE device) -> uint32_t {
+                return cm ? shout_key_.Get(*cm, device) : std::numeric_limits<uint32_t>::max();
+            };
+            InputFrame::Decode(events ? *events : nullptr, shout_key, frame_);
+
+            for (auto* subscriber : subscribers_) {
+                subscriber->OnInput(frame_);
+            }
+        });
+        return RE::BSEventNotifyControl::kContinue;
+    }
+
+    RE::BSEventNotifyControl
+    ProcessEvent(
+        const RE::MenuOpenCloseEvent* event, RE::BSTEventSource<RE::MenuOpenCloseEvent>*
+    ) override {
+        if (event && !event->opening) {
+            shout_key_.Invalidate();
         }
-        return button;
+        return RE::BSEventNotifyControl::kContinue;
     }
 
-    return nullptr;
-}
+  private:
+    explicit InputDispatcher(std::string_view shout_event) : shout_key_(shout_event) {}
 
-inline const RE::ButtonEvent*
-GetShoutButtonInput(const RE::InputEvent* events) {
-    const auto* user_events = RE::UserEvents::GetSingleton();
-    if (!user_events) {
-        return nullptr;
-    }
-    return GetUserEventButtonInput(user_events->shout, events);
-}
+    InputDispatcher(const InputDispatcher&) = delete;
+    InputDispatcher& operator=(const InputDispatcher&) = delete;
+    InputDispatcher(InputDispatcher&&) = delete;
+    InputDispatcher& operator=(InputDispatcher&&) = delete;
 
-}  // namespace internal
+    InputFrame frame_;
+    MappedKeyCache shout_key_;
+    std::vector<InputSubscriber*> subscribers_;
+};
 
 class FafHandler final : public RE::BSTEventSink<SKSE::ActionEvent> {
   public:
     [[nodiscard]] static bool
-    Init(std::mutex& mutex, Shoutmap& map, const Settings& settings) {
+    Init(const Rcu<Shoutmap>& map, const Rcu<Settings>& settings) {
         auto* action_ev_src = SKSE::GetActionEventSource();
         if (!action_ev_src) {
             return false;
         }
 
-        static auto instance = FafHandler(mutex, map, settings);
+        static auto instance = FafHandler(map, settings);
         action_ev_src->AddEventSink(&instance);
         return true;
     }
 
     RE::BSEventNotifyControl
     ProcessEvent(const SKSE::ActionEvent* event, RE::BSTEventSource<SKSE::ActionEvent>*) override {
-        Prep(event);
-        Cast(event);
+        metrics::gRegistry.Time(metrics::Probe::kFafAction, [&] {
+            Prep(event);
+            Cast(event);
+        });
         return RE::BSEventNotifyControl::kContinue;
     }
 
   private:
-    FafHandler(std::mutex& mutex, Shoutmap& map, const Settings& settings)
-        : mutex_(mutex),
-          map_(map),
-          magicka_scale_(settings.magicka_scale_faf) {}
+    FafHandler(const Rcu<Shoutmap>& map, const Rcu<Settings>& settings)
+        : map_(map),
+          settings_(settings) {}
 
     FafHandler(const FafHandler&) = delete;
     FafHandler& operator=(const FafHandler&) = delete;
@@ -110,30 +171,32 @@ class FafHandler final : public RE::BSTEventSink<SKSE::ActionEvent> {
         if (!shout) {
             return;
         }
-        RE::SpellItem* spell = nullptr;
+        auto assignment = Shoutmap::SpellAssignment();
         {
-            auto lock = std::lock_guard(mutex_);
-            spell = map_[*shout];
+            auto map = map_.Read();
+            assignment = map->Lookup(*shout);
         }
+        metrics::gRegistry.Count(metrics::Counter::kLookups);
+        auto* spell = assignment.spell;
+        const auto& profile = assignment.profile;
         if (!spell) {
-            SKSE::log::trace("faf: {} is not a spell shout or is unassigned", *shout);
+            ESAS_LOG_TRACE("faf: {} is not a spell shout or is unassigned", *shout);
             return;
         }
-        if (spell->GetCastingType() != RE::MagicSystem::CastingType::kFireAndForget) {
+        if (profile.casting_type != CastingType::kFireAndForget) {
             return;
         }
-        if (!RE::PlayerCharacter::IsGodMode()
-            && !tes_util::HasEnoughMagicka(*player, *av_owner, *spell, magicka_scale_)) {
-            SKSE::log::trace("faf: {} -> {} not enough magicka", *shout, *spell);
+        auto cost = spell->CalculateMagickaCost(player) * settings_.Read()->magicka_scale_faf;
+        if (!RE::PlayerCharacter::IsGodMode() && !tes_util::HasEnoughMagicka(*av_owner, cost)) {
+            ESAS_LOG_TRACE("faf: {} -> {} not enough magicka", *shout, *spell);
             tes_util::ActorPlayMagicFailureSound(*player);
             tes_util::FlashMagickaBar();
+            metrics::gRegistry.Count(metrics::Counter::kAbortedCasts);
             return;
         }
 
         // Bound weapon must be cast from hands.
-        auto is_bound_spell = spell->GetAVEffect()
-                              && spell->GetAVEffect()->GetArchetype()
-                                     == RE::EffectArchetypes::ArchetypeID::kBoundWeapon;
+        auto is_bound_spell = profile.bound_weapon;
         auto casting_src = RE::MagicSystem::CastingSource::kInstant;
         if (is_bound_spell) {
             if (high_data->currentShoutVariation == RE::TESShout::VariationID::kOne) {
@@ -144,65 +207,65 @@ class FafHandler final : public RE::BSTEventSink<SKSE::ActionEvent> {
         }
         auto* magic_caster = player->GetMagicCaster(casting_src);
         if (!magic_caster) {
-            SKSE::log::trace("can't get player RE::MagicCaster");
+            ESAS_LOG_TRACE("can't get player RE::MagicCaster");
+            metrics::gRegistry.Count(metrics::Counter::kAbortedCasts);
             return;
         }
 
         if (is_bound_spell) {
-            if (auto* aem = RE::ActorEquipManager::GetSingleton()) {
-                tes_util::UnequipHand(
-                    *aem, *player, casting_src == RE::MagicSystem::CastingSource::kLeftHand
-                );
+            const auto& forms = ResolvedForms::Get();
+            const auto* slot = casting_src == RE::MagicSystem::CastingSource::kLeftHand
+                                   ? forms.left_hand_slot
+                                   : forms.right_hand_slot;
+            auto* aem = RE::ActorEquipManager::GetSingleton();
+            if (aem && slot && forms.dummy_weapon) {
+                tes_util::UnequipHand(*aem, *player, *slot, *forms.dummy_weapon);
+            } else {
+                SKSE::log::error("cannot unequip hand for bound weapon spell");
             }
         }
-        tes_util::ApplyMagickaCost(*player, *av_owner, *spell, magicka_scale_);
-        tes_util::ActorPlaySound(
-            *player, tes_util::GetSpellSound(spell, RE::MagicSystem::SoundID::kRelease)
-        );
+        tes_util::ApplyMagickaCost(*av_owner, cost);
+        tes_util::ActorPlaySound(*player, profile.release_sound);
         tes_util::CastSpellImmediate(*player, *magic_caster, *spell);
-        SKSE::log::debug("faf: casting {} -> {}", *shout, *spell);
+        metrics::gRegistry.Count(metrics::Counter::kCasts);
+        ESAS_LOG_DEBUG("faf: casting {} -> {}", *shout, *spell);
     }
 
     bool shouting_ = false;
-    std::mutex& mutex_;
-    Shoutmap& map_;
-    const float magicka_scale_;
+    const Rcu<Shoutmap>& map_;
+    const Rcu<Settings>& settings_;
 };
 
-class ConcHandler final : public RE::BSTEventSink<SKSE::ActionEvent>,
-                          public RE::BSTEventSink<RE::InputEvent*> {
+class ConcHandler final : public RE::BSTEventSink<SKSE::ActionEvent>, public InputSubscriber {
   public:
     [[nodiscard]] static bool
-    Init(std::mutex& mutex, Shoutmap& map, const Settings& settings) {
+    Init(InputDispatcher& input, const Rcu<Shoutmap>& map, const Rcu<Settings>& settings) {
         auto* action_ev_src = SKSE::GetActionEventSource();
-        auto* input_ev_src = RE::BSInputDeviceManager::GetSingleton();
-        if (!action_ev_src || !input_ev_src) {
+        if (!action_ev_src) {
             return false;
         }
 
-        static auto instance = ConcHandler(mutex, map, settings);
+        static auto instance = ConcHandler(map, settings);
         action_ev_src->AddEventSink(&instance);
-        input_ev_src->AddEventSink(&instance);
+        input.Subscribe(instance);
         return true;
     }
 
     RE::BSEventNotifyControl
     ProcessEvent(const SKSE::ActionEvent* event, RE::BSTEventSource<SKSE::ActionEvent>*) override {
-        Cast(event);
+        metrics::gRegistry.Time(metrics::Probe::kConcAction, [&] { Cast(event); });
         return RE::BSEventNotifyControl::kContinue;
     }
 
-    RE::BSEventNotifyControl
-    ProcessEvent(RE::InputEvent* const* events, RE::BSTEventSource<RE::InputEvent*>*) override {
-        Poll(events);
-        return RE::BSEventNotifyControl::kContinue;
+    void
+    OnInput(const InputFrame& frame) override {
+        metrics::gRegistry.Time(metrics::Probe::kConcInput, [&] { Poll(frame); });
     }
 
   private:
-    ConcHandler(std::mutex& mutex, Shoutmap& map, const Settings& settings)
-        : mutex_(mutex),
-          map_(map),
-          magicka_scale_(settings.magicka_scale_conc) {}
+    ConcHandler(const Rcu<Shoutmap>& map, const Rcu<Settings>& settings)
+        : map_(map),
+          settings_(settings) {}
 
     ConcHandler(const ConcHandler&) = delete;
     ConcHandler& operator=(const ConcHandler&) = delete;
@@ -231,24 +294,30 @@ class ConcHandler final : public RE::BSTEventSink<SKSE::ActionEvent>,
         if (!shout) {
             return;
         }
-        RE::SpellItem* spell = nullptr;
+        auto assignment = Shoutmap::SpellAssignment();
         {
-            auto lock = std::lock_guard(mutex_);
-            spell = map_[*shout];
+            auto map = map_.Read();
+            assignment = map->Lookup(*shout);
         }
+        metrics::gRegistry.Count(metrics::Counter::kLookups);
+        auto* spell = assignment.spell;
+        const auto& profile = assignment.profile;
         if (!spell) {
-            SKSE::log::trace("conc: {} is not a spell shout or is unassigned", *shout);
+            ESAS_LOG_TRACE("conc: {} is not a spell shout or is unassigned", *shout);
             return;
         }
-        if (spell->GetCastingType() != RE::MagicSystem::CastingType::kConcentration) {
+        if (profile.casting_type != CastingType::kConcentration) {
             return;
         }
         Clear(nullptr, nullptr);
-        if (!RE::PlayerCharacter::IsGodMode() && spell->CalculateMagickaCost(player) > 0.f
+        // The caster's own cost, since gear like 100% Fortify <School> can bring it down to 0.
+        auto cost = spell->CalculateMagickaCost(player);
+        if (!RE::PlayerCharacter::IsGodMode() && cost > 0.f
             && av_owner->GetActorValue(RE::ActorValue::kMagicka) <= 0.f) {
-            SKSE::log::trace("conc: {} -> {} not enough magicka", *shout, *spell);
+            ESAS_LOG_TRACE("conc: {} -> {} not enough magicka", *shout, *spell);
             tes_util::ActorPlayMagicFailureSound(*player);
             tes_util::FlashMagickaBar();
+            metrics::gRegistry.Count(metrics::Counter::kAbortedCasts);
             // Setting current_spell_ is required in order to have Poll() reset shout cooldown.
             // Resetting cooldown in this function (in the same frame?) doesn't work.
             current_spell_ = spell;
@@ -257,24 +326,22 @@ class ConcHandler final : public RE::BSTEventSink<SKSE::ActionEvent>,
 
         auto* magic_caster = player->GetMagicCaster(RE::MagicSystem::CastingSource::kInstant);
         if (!magic_caster) {
-            SKSE::log::trace("can't get player RE::MagicCaster");
+            ESAS_LOG_TRACE("can't get player RE::MagicCaster");
+            metrics::gRegistry.Count(metrics::Counter::kAbortedCasts);
             return;
         }
 
-        loop_soundhandle_ = tes_util::ActorPlaySound(
-            *player, tes_util::GetSpellSound(spell, RE::MagicSystem::SoundID::kCastLoop)
-        );
-        tes_util::ActorPlaySound(
-            *player, tes_util::GetSpellSound(spell, RE::MagicSystem::SoundID::kRelease)
-        );
-        magic_caster->currentSpellCost = spell->CalculateMagickaCost(player) * magicka_scale_;
+        loop_soundhandle_ = tes_util::ActorPlaySound(*player, profile.loop_sound);
+        tes_util::ActorPlaySound(*player, profile.release_sound);
+        magic_caster->currentSpellCost = cost * settings_.Read()->magicka_scale_conc;
         tes_util::CastSpellImmediate(*player, *magic_caster, *spell);
+        metrics::gRegistry.Count(metrics::Counter::kCasts);
         current_spell_ = spell;
-        SKSE::log::debug("conc: casting {} -> {}", *shout, *spell);
+        ESAS_LOG_DEBUG("conc: casting {} -> {}", *shout, *spell);
     }
 
     void
-    Poll(RE::InputEvent* const* events) {
+    Poll(const InputFrame& frame) {
         if (!current_spell_) {
             return;
         }
@@ -301,12 +368,7 @@ class ConcHandler final : public RE::BSTEventSink<SKSE::ActionEvent>,
             return;
         }
 
-        if (!events) {
-            Clear(player, magic_caster);
-            return;
-        }
-        const auto* button = internal::GetShoutButtonInput(*events);
-        if (!button || button->IsUp()) {
+        if (frame.shout_button() != ShoutButton::kDown) {
             Clear(player, magic_caster);
             return;
         }
@@ -336,38 +398,41 @@ class ConcHandler final : public RE::BSTEventSink<SKSE::ActionEvent>,
 
     RE::SpellItem* current_spell_ = nullptr;
     std::optional<RE::BSSoundHandle> loop_soundhandle_;
-    std::mutex& mutex_;
-    Shoutmap& map_;
-    const float magicka_scale_;
+    const Rcu<Shoutmap>& map_;
+    const Rcu<Settings>& settings_;
 };
 
-class AssignmentHandler final : public RE::BSTEventSink<RE::InputEvent*> {
+class AssignmentHandler final : public InputSubscriber {
   public:
+    /// `map` is the writable shoutmap guarded by `mutex`. Every change to it is published to
+    /// `snapshot`, which is what the cast handlers read from.
     [[nodiscard]] static bool
-    Init(std::mutex& mutex, Shoutmap& map, const Settings& settings) {
-        auto* input_ev_src = RE::BSInputDeviceManager::GetSingleton();
-        if (!input_ev_src) {
-            return false;
-        }
-
-        static auto instance = AssignmentHandler(mutex, map, settings);
-        input_ev_src->AddEventSink(&instance);
+    Init(
+        InputDispatcher& input,
+        std::mutex& mutex,
+        Shoutmap& map,
+        Rcu<Shoutmap>& snapshot,
+        const Rcu<Settings>& settings
+    ) {
+        static auto instance = AssignmentHandler(mutex, map, snapshot, settings);
+        input.Subscribe(instance);
         return true;
     }
 
-    RE::BSEventNotifyControl
-    ProcessEvent(RE::InputEvent* const* events, RE::BSTEventSource<RE::InputEvent*>*) override {
-        HandleInput(events);
-        return RE::BSEventNotifyControl::kContinue;
+    void
+    OnInput(const InputFrame& frame) override {
+        metrics::gRegistry.Time(metrics::Probe::kAssignmentInput, [&] { HandleInput(frame); });
     }
 
   private:
-    AssignmentHandler(std::mutex& mutex, Shoutmap& map, const Settings& settings)
+    AssignmentHandler(
+        std::mutex& mutex, Shoutmap& map, Rcu<Shoutmap>& snapshot, const Rcu<Settings>& settings
+    )
         : mutex_(mutex),
           map_(map),
-          allow_2h_(settings.allow_2h_spells),
-          assign_keysets_(settings.convert_spell_keysets),
-          unassign_keysets_(settings.remove_shout_keysets) {}
+          snapshot_(snapshot),
+          settings_(settings),
+          commands_(settings.Read()->console_shout_commands) {}
 
     AssignmentHandler(const AssignmentHandler&) = delete;
     AssignmentHandler& operator=(const AssignmentHandler&) = delete;
@@ -375,13 +440,9 @@ class AssignmentHandler final : public RE::BSTEventSink<RE::InputEvent*> {
     AssignmentHandler& operator=(AssignmentHandler&&) = delete;
 
     void
-    HandleInput(RE::InputEvent* const* events) {
-        if (!events) {
-            return;
-        }
-        buf_.clear();
-        Keystroke::InputEventsToBuffer(*events, buf_);
-        if (buf_.empty()) {
+    HandleInput(const InputFrame& frame) {
+        const auto& keystrokes = frame.keystrokes();
+        if (keystrokes.empty()) {
             return;
         }
 
@@ -389,34 +450,48 @@ class AssignmentHandler final : public RE::BSTEventSink<RE::InputEvent*> {
         if (!player) {
             return;
         }
-        if (assign_keysets_.Match(buf_) == Keypress::kPress) {
-            Assign(*player);
+        // One snapshot for the whole frame, so a reload can't land between the two keyset matches.
+        auto settings = settings_.Read();
+        commands_.SetUseConsole(settings->console_shout_commands);
+        if (settings->convert_spell_keysets.Match(keystrokes) == Keypress::kPress) {
+            Assign(*player, settings->allow_2h_spells);
         }
-        if (unassign_keysets_.Match(buf_) == Keypress::kPress) {
+        if (settings->remove_shout_keysets.Match(keystrokes) == Keypress::kPress) {
             Unassign(*player);
         }
+        if (settings->save_loadout_keysets.Match(keystrokes) == Keypress::kPress) {
+            SaveLoadout(*player);
+        }
+        if (settings->apply_loadout_keysets.Match(keystrokes) == Keypress::kPress) {
+            ApplyLoadout(*player, settings->allow_2h_spells);
+        }
+        commands_.Flush();
+    }
+
+    static bool
+    IsAssignable(const RE::SpellItem& spell, bool allow_2h) {
+        if (!tes_util::IsHandEquippedSpell(spell, allow_2h)) {
+            ESAS_LOG_TRACE("{} is not eligible for spell shout assignment", spell);
+            return false;
+        }
+        auto ct = spell.GetCastingType();
+        return ct == RE::MagicSystem::CastingType::kFireAndForget
+               || ct == RE::MagicSystem::CastingType::kConcentration;
     }
 
     void
-    Assign(RE::Actor& player) {
+    Assign(RE::Actor& player, bool allow_2h) {
         auto* spell = tes_util::GetRightHandSpellItem(player);
-        if (!spell) {
-            return;
-        }
-        if (!tes_util::IsHandEquippedSpell(*spell, allow_2h_)) {
-            SKSE::log::trace("{} is not eligible for spell shout assignment", *spell);
-            return;
-        }
-        auto ct = spell->GetCastingType();
-        if (ct != RE::MagicSystem::CastingType::kFireAndForget
-            && ct != RE::MagicSystem::CastingType::kConcentration) {
+        if (!spell || !IsAssignable(*spell, allow_2h)) {
             return;
         }
 
-        SKSE::log::debug("assigning {} ...", *spell);
+        ESAS_LOG_DEBUG("assigning {} ...", *spell);
+        auto lock = Lock();
         RE::TESShout* shout = nullptr;
-        switch (auto status = map_.Assign(player, *spell, shout)) {
+        switch (auto status = map_.Assign(player, *spell, commands_, shout)) {
             case Shoutmap::AssignStatus::kOk:
+                snapshot_.Publish(std::make_unique<const Shoutmap>(map_));
                 tes_util::DebugNotification("{} added", shout->GetName());
                 break;
             case Shoutmap::AssignStatus::kAlreadyAssigned:
@@ -443,14 +518,15 @@ class AssignmentHandler final : public RE::BSTEventSink<RE::InputEvent*> {
         if (!shout) {
             return;
         }
-        auto lock = std::lock_guard(mutex_);
+        auto lock = Lock();
         if (!map_.Has(*shout)) {
             return;
         }
 
-        SKSE::log::debug("unassigning {} ...", *shout);
-        switch (auto status = map_.Unassign(player, *shout)) {
+        ESAS_LOG_DEBUG("unassigning {} ...", *shout);
+        switch (auto status = map_.Unassign(player, *shout, commands_)) {
             case Shoutmap::AssignStatus::kOk:
+                snapshot_.Publish(std::make_unique<const Shoutmap>(map_));
                 tes_util::DebugNotification("{} removed", shout->GetName());
                 break;
             default:
@@ -463,12 +539,77 @@ class AssignmentHandler final : public RE::BSTEventSink<RE::InputEvent*> {
         }
     }
 
-    std::vector<Keystroke> buf_;
+    void
+    SaveLoadout(const RE::Actor& player) {
+        auto name = LoadoutNameFromStr(player.GetName());
+        auto loadout = Loadout();
+        {
+            auto lock = Lock();
+            loadout = ShoutmapToLoadout(map_, ShoutSet(tes_util::GetShouts(player)));
+        }
+        if (!esas::SaveLoadout(fs::kLoadoutsDir, name, loadout)) {
+            SKSE::log::error("cannot save loadout '{}' to '{}'", name, fs::kLoadoutsDir);
+            return;
+        }
+        ESAS_LOG_DEBUG("saved {} spell(s) to loadout '{}'", loadout.spells.size(), name);
+        tes_util::DebugNotification("Loadout {} saved", name);
+    }
+
+    /// Applies the whole loadout as a single batch: one shoutmap update, one snapshot, and one
+    /// flush of console commands.
+    void
+    ApplyLoadout(RE::Actor& player, bool allow_2h) {
+        auto name = LoadoutNameFromStr(player.GetName());
+        auto loadout = LoadLoadout(fs::kLoadoutsDir, name);
+        if (!loadout) {
+            ESAS_LOG_DEBUG("loadout '{}' not found in '{}'", name, fs::kLoadoutsDir);
+            tes_util::DebugNotification("No loadout saved for {}", name);
+            return;
+        }
+        auto spells = LoadoutSpells(*loadout);
+        std::erase_if(spells, [allow_2h](const RE::SpellItem* spell) {
+            return !IsAssignable(*spell, allow_2h);
+        });
+
+        ESAS_LOG_DEBUG("applying loadout '{}' ...", name);
+        auto lock = Lock();
+        auto result = map_.ApplyLoadout(player, spells, commands_);
+        if (result.assigned > 0 || result.unassigned > 0) {
+            snapshot_.Publish(std::make_unique<const Shoutmap>(map_));
+        }
+        ESAS_LOG_DEBUG(
+            "loadout '{}': {} assigned, {} unassigned, {} failed",
+            name,
+            result.assigned,
+            result.unassigned,
+            result.failed
+        );
+        if (result.failed > 0) {
+            tes_util::DebugNotification(
+                "Loadout {} applied, {} spell(s) could not be assigned", name, result.failed
+            );
+        } else {
+            tes_util::DebugNotification("Loadout {} applied", name);
+        }
+    }
+
+    /// Locks `mutex_`, counting contention.
+    std::unique_lock<std::mutex>
+    Lock() {
+        auto lock = std::unique_lock(mutex_, std::try_to_lock);
+        if (!lock) {
+            metrics::gRegistry.Count(metrics::Counter::kMutexWaits);
+            lock.lock();
+        }
+        return lock;
+    }
+
     std::mutex& mutex_;
     Shoutmap& map_;
-    const bool allow_2h_;
-    const Keysets assign_keysets_;
-    const Keysets unassign_keysets_;
+    Rcu<Shoutmap>& snapshot_;
+    const Rcu<Settings>& settings_;
+    /// Flushed once per input frame.
+    ShoutCommands commands_;
 };
 
 }  // namespace esas
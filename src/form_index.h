@@ -0,0 +1,154 @@
+// Open-addressing hash index keyed by form ID.
+#pragma once
+
+namespace esas {
+
+/// Maps form IDs to slot indices. Lookups, insertions and erasures are O(1) on average.
+///
+/// Uses linear probing with backward-shift deletion (no tombstones), so a lookup is a multiply, a
+/// shift, and a short scan over adjacent buckets.
+///
+/// Invariants:
+/// - `buckets_.size()` is 0 or a power of 2 no smaller than `kMinBuckets`.
+/// - At most half of `buckets_` is occupied.
+/// - A bucket with key 0 is empty. Form ID 0 is never a valid form, so it is never stored.
+class FormIndex final {
+  public:
+    static constexpr uint32_t kNotFound = std::numeric_limits<uint32_t>::max();
+
+    FormIndex() = default;
+
+    /// Reserves room for `n` entries, so that inserting up to `n` entries never rehashes.
+    explicit FormIndex(size_t n) {
+        Rehash(BucketCountFor(n));
+    }
+
+    size_t
+    size() const {
+        return size_;
+    }
+
+    bool
+    empty() const {
+        return size_ == 0;
+    }
+
+    /// Returns `kNotFound` if `id` is not in the index.
+    uint32_t
+    Find(uint32_t id) const {
+        if (id == 0 || buckets_.empty()) {
+            return kNotFound;
+        }
+        auto mask = buckets_.size() - 1;
+        for (auto b = Home(id);; b = (b + 1) & mask) {
+            const auto& bucket = buckets_[b];
+            if (bucket.key == id) {
+                return bucket.val;
+            }
+            if (bucket.key == 0) {
+                return kNotFound;
+            }
+        }
+    }
+
+    /// Inserts `id`, or overwrites its value if already present. No-op if `id` is 0.
+    void
+    Insert(uint32_t id, uint32_t val) {
+        if (id == 0) {
+            return;
+        }
+        if ((size_ + 1) * 2 > buckets_.size()) {
+            Rehash(BucketCountFor(size_ + 1));
+        }
+        auto mask = buckets_.size() - 1;
+        for (auto b = Home(id);; b = (b + 1) & mask) {
+            auto& bucket = buckets_[b];
+            if (bucket.key == id) {
+                bucket.val = val;
+                return;
+            }
+            if (bucket.key == 0) {
+                bucket = {.key = id, .val = val};
+                size_++;
+                return;
+            }
+        }
+    }
+
+    /// Returns false if `id` was not in the index.
+    bool
+    Erase(uint32_t id) {
+        if (id == 0 || buckets_.empty()) {
+            return false;
+        }
+        auto mask = buckets_.size() - 1;
+        auto hole = Home(id);
+        for (;; hole = (hole + 1) & mask) {
+            if (buckets_[hole].key == id) {
+                break;
+            }
+            if (buckets_[hole].key == 0) {
+                return false;
+            }
+        }
+
+        // Shift subsequent entries of the same probe run back into the hole, so that lookups never
+        // stop early at an empty bucket.
+        for (auto b = (hole + 1) & mask; buckets_[b].key != 0; b = (b + 1) & mask) {
+            auto home = Home(buckets_[b].key);
+            // Move the entry only if its home bucket is not cyclically within (hole, b].
+            if (((b - home) & mask) >= ((b - hole) & mask)) {
+                buckets_[hole] = buckets_[b];
+                hole = b;
+            }
+        }
+        buckets_[hole] = {};
+        size_--;
+        return true;
+    }
+
+    /// Removes all entries but keeps allocated buckets.
+    void
+    Clear() {
+        std::fill(buckets_.begin(), buckets_.end(), Bucket());
+        size_ = 0;
+    }
+
+  private:
+    struct Bucket {
+        uint32_t key = 0;
+        uint32_t val = 0;
+    };
+
+    static constexpr size_t kMinBuckets = 8;
+
+    static size_t
+    BucketCountFor(size_t n) {
+        return std::max(kMinBuckets, std::bit_ceil(n * 2));
+    }
+
+    /// Fibonacci hashing: takes the top bits of the product, which mixes well even for runs of
+    /// consecutive form IDs that share a load order index in the high byte.
+    size_t
+    Home(uint32_t id) const {
+        return static_cast<uint32_t>(id * 0x9e3779b1u) >> shift_;
+    }
+
+    void
+    Rehash(size_t bucket_count) {
+        auto old = std::exchange(buckets_, std::vector<Bucket>(bucket_count));
+        shift_ = 32 - std::countr_zero(bucket_count);
+        size_ = 0;
+        for (const auto& bucket : old) {
+            if (bucket.key != 0) {
+                Insert(bucket.key, bucket.val);
+            }
+        }
+    }
+
+    std::vector<Bucket> buckets_;
+    int shift_ = 32;
+    size_t size_ = 0;
+};
+
+}  // namespace esas
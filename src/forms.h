@@ -0,0 +1,93 @@
+// Forms that the plugin looks up by ID, resolved once after game data loads.
+#pragma once
+
+#include "tes_util.h"
+
+namespace esas {
+
+inline constexpr std::string_view kModname = ESAS_NAME ".esp";
+
+/// Lookups through `RE::TESDataHandler` go through a file name search and a form map search, so
+/// forms needed on hot paths are resolved once, at `kDataLoaded`, and read from here. Any pointer
+/// may be null if its form can't be found.
+struct ResolvedForms final {
+    /// The word of power that players must know in order to cast this mod's shouts.
+    RE::TESWordOfPower* word = nullptr;
+
+    /// Word of power that players should never know. Used to prevent casting the level 2/3
+    /// variations of concentration shouts.
+    ///
+    /// Concentration shouts are NOT triggered by the release of the shout button; rather, player
+    /// keeps the shout button held, and waits until the shout startup animation finishes. Knowing
+    /// words 2 or 3 results in a longer startup.
+    RE::TESWordOfPower* unlearned_word = nullptr;
+
+    /// Placeholder shout that does not participate in spell assignments.
+    ///
+    /// On learning a word of power, the corresponding shout gets auto-added to the player's
+    /// inventory. If multiple shouts share the same word, the shout with the lowest form ID is the
+    /// one that gets added. This default shout functions as that "shout with lowest ID", and we
+    /// unconditionally remove it from the player's inventory after teachword finishes. If this
+    /// shout did not exist, teachword would add a real shout, and we would have to check whether we
+    /// should remove that shout (was the shout meant to be assigned, or was it added purely due to
+    /// teachword?)
+    RE::TESShout* default_shout = nullptr;
+
+    /// The real shouts from the plugin, i.e. the ones that get spell assignments before any
+    /// dynamic shouts are needed. Never contains null.
+    std::vector<RE::TESShout*> shouts;
+
+    const RE::BGSEquipSlot* left_hand_slot = nullptr;
+    const RE::BGSEquipSlot* right_hand_slot = nullptr;
+    /// Equipped and immediately unequipped to empty a hand.
+    RE::TESObjectWEAP* dummy_weapon = nullptr;
+
+    /// Looks up every form.
+    static ResolvedForms
+    Resolve() {
+        auto forms = ResolvedForms{
+            .word = tes_util::GetForm<RE::TESWordOfPower>(kModname, 0x801),
+            .unlearned_word = tes_util::GetForm<RE::TESWordOfPower>(kModname, 0x802),
+            .default_shout = tes_util::GetForm<RE::TESShout>(kModname, 0x8ff),
+            .left_hand_slot = tes_util::GetForm<RE::BGSEquipSlot>(tes_util::kEqupLeftHand),
+            .right_hand_slot = tes_util::GetForm<RE::BGSEquipSlot>(tes_util::kEqupRightHand),
+            .dummy_weapon = tes_util::GetForm<RE::TESObjectWEAP>(tes_util::kWeapDummy),
+        };
+        constexpr RE::FormID first = 0x900;
+        constexpr RE::FormID count = 30;
+        for (RE::FormID i = 0; i < count; i++) {
+            auto* shout = tes_util::GetForm<RE::TESShout>(kModname, first + i);
+            if (shout) {
+                forms.shouts.push_back(shout);
+            }
+        }
+        return forms;
+    }
+
+    /// Forms as of the last `Refresh()`. All null/empty before the first.
+    static const ResolvedForms&
+    Get() {
+        return Instance();
+    }
+
+    /// Resolves every form. Call once, on `kDataLoaded`, before anything reads `Get()`.
+    ///
+    /// There is no point at which to call this again: the game loads plugin data once per process
+    /// and never reloads it (loading a save or starting a new game only resets form state, not the
+    /// forms themselves), so resolved pointers stay valid for the rest of the session. That's also
+    /// what lets `Shoutmap` keep `shouts` pointers across saves. A second call would leave any
+    /// existing `Shoutmap` holding pointers from the first.
+    static void
+    Refresh() {
+        Instance() = Resolve();
+    }
+
+  private:
+    static ResolvedForms&
+    Instance() {
+        static auto forms = ResolvedForms();
+        return forms;
+    }
+};
+
+}  // namespace esas
@@ -15,33 +15,93 @@ EnsureDirExists(const std::filesystem::path& p) {
 }  // namespace internal
 
 inline constexpr std::string_view kSettingsPath = "Data/SKSE/Plugins/" ESAS_NAME ".json";
+inline constexpr std::string_view kLoadoutsDir = "Data/SKSE/Plugins/" ESAS_NAME "/loadouts";
 
+/// Returns nullopt if `s` is not valid UTF-8.
 inline std::optional<std::filesystem::path>
 PathFromStr(std::string_view s) {
-    return SKSE::stl::utf8_to_utf16(s).transform([](std::wstring&& ws) {
-        return std::filesystem::path(std::move(ws));
-    });
+    try {
+        return std::filesystem::path(
+            std::u8string_view(reinterpret_cast<const char8_t*>(s.data()), s.size())
+        );
+    } catch (const std::system_error&) {
+        return std::nullopt;
+    }
 }
 
+/// Returns nullopt if `p` cannot be represented as UTF-8.
 inline std::optional<std::string>
 StrFromPath(const std::filesystem::path& p) {
-    return SKSE::stl::utf16_to_utf8(p.c_str());
+    try {
+        auto u8 = p.u8string();
+        return std::string(reinterpret_cast<const char*>(u8.data()), u8.size());
+    } catch (const std::system_error&) {
+        return std::nullopt;
+    }
 }
 
-/// Returns nullopt on failure.
-inline std::optional<std::string>
-ReadFile(std::string_view path) {
-    auto fp = PathFromStr(path);
-    if (!fp) {
-        return std::nullopt;
+/// A file's contents, read with a single `read()` into a buffer that is allocated once and freed
+/// along with this object. No stream buffering and no copies beyond the read itself, so parsers can
+/// work on `view()` in place.
+class FileContents final {
+  public:
+    FileContents(const FileContents&) = delete;
+    FileContents& operator=(const FileContents&) = delete;
+    FileContents(FileContents&&) = default;
+    FileContents& operator=(FileContents&&) = default;
+
+    /// Returns nullopt if `path` is not a regular file or cannot be read. The file is read as
+    /// binary, so line endings are left as is.
+    static std::optional<FileContents>
+    Read(std::string_view path) {
+        auto fp = PathFromStr(path);
+        if (!fp) {
+            return std::nullopt;
+        }
+        auto ec = std::error_code();
+        auto size = std::filesystem::file_size(*fp, ec);
+        if (ec) {
+            return std::nullopt;
+        }
+        auto f = std::ifstream(*fp, std::ios::binary);
+        if (!f.is_open()) {
+            return std::nullopt;
+        }
+
+        auto contents = FileContents();
+        contents.data_ = std::make_unique_for_overwrite<char[]>(size);
+        f.read(contents.data_.get(), static_cast<std::streamsize>(size));
+        if (f.bad()) {
+            return std::nullopt;
+        }
+        // Fewer bytes than expected if the file shrank since `file_size()`.
+        contents.size_ = static_cast<size_t>(f.gcount());
+        return contents;
     }
-    auto f = std::ifstream(*fp);
-    if (!f.is_open()) {
-        return std::nullopt;
+
+    std::string_view
+    view() const {
+        return {data_.get(), size_};
+    }
+
+    size_t
+    size() const {
+        return size_;
     }
-    std::ostringstream ss;
-    ss << f.rdbuf();
-    return ss.str();
+
+  private:
+    FileContents() = default;
+
+    std::unique_ptr<char[]> data_;
+    size_t size_ = 0;
+};
+
+/// Like `FileContents::Read()`, but returns an owned string. Returns nullopt on failure.
+inline std::optional<std::string>
+ReadFile(std::string_view path) {
+    return FileContents::Read(path).transform([](const FileContents& contents) {
+        return std::string(contents.view());
+    });
 }
 
 /// Will create intermediate directories as needed. Returns false on failure.
@@ -93,7 +153,7 @@ ListDirToBuf(std::string_view dir_path, std::vector<std::string>& buf) {
     }
     auto ec = std::error_code();
     auto it = std::filesystem::directory_iterator(*dp, ec);
-    if (ec.value() == ERROR_PATH_NOT_FOUND) {
+    if (ec == std::errc::no_such_file_or_directory) {
         return true;
     }
     if (ec) {
@@ -0,0 +1,144 @@
+// Per-frame input decoding shared by all input-consuming handlers.
+#pragma once
+
+#include "keys.h"
+
+namespace esas {
+
+/// State of the shout button within one input frame.
+enum class ShoutButton {
+    /// No event for the shout button this frame.
+    kAbsent,
+    kDown,
+    kUp,
+};
+
+/// Input events from a single frame, decoded once and shared by every subscriber.
+class InputFrame final {
+  public:
+    void
+    Clear() {
+        keystroke_list_.clear();
+        keystrokes_.Fold({});
+        shout_button_ = ShoutButton::kAbsent;
+    }
+
+    /// Pressed keys, folded for keyset matching.
+    const KeystrokeFrame&
+    keystrokes() const {
+        return keystrokes_;
+    }
+
+    /// Pressed keys in event order.
+    std::span<const Keystroke>
+    keystroke_list() const {
+        return keystroke_list_;
+    }
+
+    ShoutButton
+    shout_button() const {
+        return shout_button_;
+    }
+
+    /// Decodes an input event chain into `frame`, replacing its previous contents.
+    ///
+    /// `shout_key(device)` must return the ID code mapped to the shout button for `device`, where
+    /// `device` is whatever the events' `GetDevice()` returns. It is only called until the shout
+    /// button is found.
+    template <typename Event, typename ShoutKeyFn>
+    static void
+    Decode(const Event* events, const ShoutKeyFn& shout_key, InputFrame& frame) {
+        frame.Clear();
+        for (; events; events = events->next) {
+            const auto* button = events->AsButtonEvent();
+            if (!button || !button->HasIDCode()) {
+                continue;
+            }
+            auto idcode = button->GetIDCode();
+            auto device = button->GetDevice();
+
+            if (frame.shout_button_ == ShoutButton::kAbsent && shout_key(device) == idcode) {
+                frame.shout_button_ = button->IsUp() ? ShoutButton::kUp : ShoutButton::kDown;
+            }
+            if (button->IsPressed()) {
+                auto keystroke = Keystroke::New(
+                    KeycodeFromScancode(idcode, static_cast<InputDevice>(device)),
+                    button->HeldDuration()
+                );
+                if (keystroke) {
+                    frame.keystroke_list_.push_back(*keystroke);
+                }
+            }
+        }
+        frame.keystrokes_.Fold(frame.keystroke_list_);
+    }
+
+  private:
+    std::vector<Keystroke> keystroke_list_;
+    KeystrokeFrame keystrokes_;
+    ShoutButton shout_button_ = ShoutButton::kAbsent;
+};
+
+/// Caches a control map's mapped ID code for one user event, per input device, so that per-event
+/// lookups are an array read instead of a string-keyed search.
+///
+/// `Get()` must only be called from one thread at a time. `Invalidate()` may be called from any
+/// thread; cached entries are dropped on the next `Get()`.
+class MappedKeyCache final {
+  public:
+    /// `user_event` should be a member of `RE::UserEvents` and must outlive the cache.
+    explicit MappedKeyCache(std::string_view user_event = "") : user_event_(user_event) {}
+
+    std::string_view
+    user_event() const {
+        return user_event_;
+    }
+
+    /// Returns `cm.GetMappedKey(user_event(), device)`, querying `cm` only on a cache miss.
+    template <typename ControlMap, typename Device>
+    uint32_t
+    Get(const ControlMap& cm, Device device) {
+        auto gen = generation_.load(std::memory_order_acquire);
+        if (gen != cached_generation_) {
+            valid_.fill(false);
+            cached_generation_ = gen;
+        }
+
+        auto i = static_cast<size_t>(device);
+        if (i >= kDeviceCount) {
+            return cm.GetMappedKey(user_event_, device);
+        }
+        if (!valid_[i]) {
+            keys_[i] = cm.GetMappedKey(user_event_, device);
+            valid_[i] = true;
+        }
+        return keys_[i];
+    }
+
+    /// Call whenever controls may have been remapped.
+    void
+    Invalidate() {
+        generation_.fetch_add(1, std::memory_order_release);
+    }
+
+  private:
+    /// Keyboard, mouse, gamepad, virtual keyboard.
+    static constexpr size_t kDeviceCount = 4;
+
+    std::string_view user_event_;
+    std::array<uint32_t, kDeviceCount> keys_{};
+    std::array<bool, kDeviceCount> valid_{};
+    uint32_t cached_generation_ = 0;
+    std::atomic<uint32_t> generation_ = 0;
+};
+
+class InputSubscriber {
+  public:
+    virtual ~InputSubscriber() = default;
+
+    /// Called once per input frame, on the thread that dispatches input events.
+    virtual void
+    OnInput(const InputFrame& frame) = 0;
+};
+
+}  // namespace esas
@@ -299,15 +299,241 @@ KeycodeIsValid(uint32_t keycode) {
     return !KeycodeName(keycode).empty();
 }
 
-/// If name is unknown, returns 0.
+/// Alternative spellings accepted by `KeycodeFromNameLoose()`. Must not collide with each other or
+/// with `kKeycodeNames`, ignoring case.
+inline constexpr auto kKeycodeAliases = std::array<std::pair<std::string_view, uint32_t>, 35>{{
+    {"Escape", 1},
+    {"Minus", 12},
+    {"Equals", 13},
+    {"LBracket", 26},
+    {"RBracket", 27},
+    {"Return", 28},
+    {"LeftCtrl", 29},
+    {"LControl", 29},
+    {"Semicolon", 39},
+    {"Apostrophe", 40},
+    {"Grave", 41},
+    {"Tilde", 41},
+    {"LeftShift", 42},
+    {"Backslash", 43},
+    {"Comma", 51},
+    {"Period", 52},
+    {"Slash", 53},
+    {"RightShift", 54},
+    {"NumpadMultiply", 55},
+    {"LeftAlt", 56},
+    {"NumpadMinus", 74},
+    {"NumpadPlus", 78},
+    {"NumpadPeriod", 83},
+    {"RightCtrl", 157},
+    {"RControl", 157},
+    {"NumpadDivide", 181},
+    {"PrintScreen", 183},
+    {"RightAlt", 184},
+    {"PgUp", 201},
+    {"PgDn", 209},
+    {"Ins", 210},
+    {"Del", 211},
+    {"LeftMouse", 256},
+    {"RightMouse", 257},
+    {"MiddleMouse", 258},
+}};
+
+namespace internal {
+
+constexpr char
+AsciiLower(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+constexpr bool
+AsciiIEquals(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (AsciiLower(a[i]) != AsciiLower(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Case-insensitive FNV-1a.
+constexpr uint64_t
+KeyNameHash(std::string_view name) {
+    auto h = uint64_t(0xcbf29ce484222325);
+    for (auto c : name) {
+        h ^= static_cast<unsigned char>(AsciiLower(c));
+        h *= 0x100000001b3;
+    }
+    return h;
+}
+
+/// splitmix64 finalizer.
+constexpr uint64_t
+KeyNameMix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+    return x ^ (x >> 31);
+}
+
+/// Perfect hash (hash-and-displace) over the lowercased forms of every name in
+/// `kKeycodeNames` and `kKeycodeAliases`. A lookup hashes the name once, reads one displacement and
+/// one slot, then does a single string comparison.
+///
+/// Entry `e` refers to `kKeycodeNames[e]` if `e < kKeycodeNames.size()`, otherwise to
+/// `kKeycodeAliases[e - kKeycodeNames.size()]`.
+class KeyNameTable final {
+  public:
+    static constexpr size_t kBucketBits = 6;
+    static constexpr size_t kSlotBits = 9;
+    static constexpr uint16_t kEmpty = std::numeric_limits<uint16_t>::max();
+
+    static constexpr size_t kEntryCount = kKeycodeNames.size() + kKeycodeAliases.size();
+    static_assert(kEntryCount < kEmpty);
+
+    static constexpr std::string_view
+    EntryName(size_t e) {
+        return e < kKeycodeNames.size() ? kKeycodeNames[e]
+                                        : kKeycodeAliases[e - kKeycodeNames.size()].first;
+    }
+
+    static constexpr uint32_t
+    EntryKeycode(size_t e) {
+        return e < kKeycodeNames.size() ? static_cast<uint32_t>(e)
+                                        : kKeycodeAliases[e - kKeycodeNames.size()].second;
+    }
+
+    /// Fails (`ok() == false`) if no displacement separates some bucket, which in practice only
+    /// happens when two names are equal ignoring case.
+    static constexpr KeyNameTable
+    Build() {
+        auto t = KeyNameTable();
+        t.slots_.fill(kEmpty);
+
+        auto hashes = std::array<uint64_t, kEntryCount>();
+        auto counts = std::array<size_t, kBuckets>();
+        auto members = std::array<std::array<uint16_t, kMaxBucketSize>, kBuckets>();
+        for (size_t e = 0; e < kEntryCount; e++) {
+            auto name = EntryName(e);
+            if (name.empty()) {
+                continue;
+            }
+            hashes[e] = KeyNameHash(name);
+            auto b = Bucket(hashes[e]);
+            if (counts[b] == kMaxBucketSize) {
+                return t;
+            }
+            members[b][counts[b]++] = static_cast<uint16_t>(e);
+        }
+
+        // Place the largest buckets first, while the table is emptiest.
+        auto order = std::array<size_t, kBuckets>();
+        for (size_t b = 0; b < kBuckets; b++) {
+            order[b] = b;
+        }
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return counts[a] > counts[b];
+        });
+
+        for (auto b : order) {
+            if (!t.Place(b, hashes, members[b], counts[b])) {
+                return t;
+            }
+        }
+        t.ok_ = true;
+        return t;
+    }
+
+    constexpr bool
+    ok() const {
+        return ok_;
+    }
+
+    /// Returns the only entry that could be named `name` (ignoring case), or `kEmpty`. The caller
+    /// must still compare names.
+    constexpr uint16_t
+    Candidate(std::string_view name) const {
+        auto h = KeyNameHash(name);
+        return slots_[Slot(h, displacements_[Bucket(h)])];
+    }
+
+  private:
+    static constexpr size_t kBuckets = size_t(1) << kBucketBits;
+    static constexpr size_t kSlots = size_t(1) << kSlotBits;
+    static constexpr size_t kMaxBucketSize = 16;
+    static constexpr uint16_t kMaxDisplacement = 4096;
+
+    static constexpr size_t
+    Bucket(uint64_t h) {
+        return static_cast<size_t>(KeyNameMix(h) >> (64 - kBucketBits));
+    }
+
+    static constexpr size_t
+    Slot(uint64_t h, uint16_t displacement) {
+        return static_cast<size_t>(
+            KeyNameMix(h + displacement * uint64_t(0x9e3779b97f4a7c15)) >> (64 - kSlotBits)
+        );
+    }
+
+    /// Finds a displacement that puts every member of bucket `b` into a distinct empty slot.
+    constexpr bool
+    Place(
+        size_t b,
+        const std::array<uint64_t, kEntryCount>& hashes,
+        const std::array<uint16_t, kMaxBucketSize>& members,
+        size_t count
+    ) {
+        for (uint16_t d = 0; d < kMaxDisplacement; d++) {
+            auto placed = size_t(0);
+            for (; placed < count; placed++) {
+                auto& slot = slots_[Slot(hashes[members[placed]], d)];
+                if (slot != kEmpty) {
+                    break;
+                }
+                slot = members[placed];
+            }
+            if (placed == count) {
+                displacements_[b] = d;
+                return true;
+            }
+            for (size_t i = 0; i < placed; i++) {
+                slots_[Slot(hashes[members[i]], d)] = kEmpty;
+            }
+        }
+        return false;
+    }
+
+    std::array<uint16_t, kBuckets> displacements_{};
+    std::array<uint16_t, kSlots> slots_{};
+    bool ok_ = false;
+};
+
+inline constexpr auto kKeyNameTable = KeyNameTable::Build();
+static_assert(kKeyNameTable.ok(), "key names must be unique ignoring case");
+
+}  // namespace internal
+
+/// If name is unknown, returns 0. Case-sensitive, and only accepts names from `kKeycodeNames`.
 constexpr uint32_t
 KeycodeFromName(std::string_view name) {
-    for (uint32_t i = 0; i < kKeycodeNames.size(); i++) {
-        if (name == kKeycodeNames[i]) {
-            return i;
-        }
+    auto e = internal::kKeyNameTable.Candidate(name);
+    if (e >= kKeycodeNames.size() || kKeycodeNames[e] != name) {
+        return 0;
     }
-    return 0;
+    return e;
+}
+
+/// Like `KeycodeFromName()`, but case-insensitive, and also accepts names from `kKeycodeAliases`.
+constexpr uint32_t
+KeycodeFromNameLoose(std::string_view name) {
+    using internal::KeyNameTable;
+    auto e = internal::kKeyNameTable.Candidate(name);
+    if (e == KeyNameTable::kEmpty || !internal::AsciiIEquals(KeyNameTable::EntryName(e), name)) {
+        return 0;
+    }
+    return KeyNameTable::EntryKeycode(e);
 }
 
 /// Normalizes invalid keycodes to 0. Valid keycodes are left as is.
@@ -316,17 +542,60 @@ KeycodeNormalized(uint32_t keycode) {
     return KeycodeIsValid(keycode) ? keycode : 0;
 }
 
+/// Mirrors `RE::INPUT_DEVICE`.
+enum class InputDevice : uint32_t {
+    kKeyboard = 0,
+    kMouse,
+    kGamepad,
+    kVirtualKeyboard,
+};
+
+/// Keycodes of the first mouse button and first gamepad button, as in `SKSE::InputMap`.
+inline constexpr uint32_t kMouseKeycodeOffset = 256;
+inline constexpr uint32_t kGamepadKeycodeOffset = 266;
+
+/// Converts an XInput button mask (or the game's pseudo-masks for the triggers) to a keycode, like
+/// `SKSE::InputMap::GamepadMaskToKeycode()`. If the mask is unknown, returns 0.
+constexpr uint32_t
+KeycodeFromGamepadMask(uint32_t mask) {
+    constexpr auto masks = std::array<uint32_t, 16>{
+        0x0001,  // DpadUp
+        0x0002,  // DpadDown
+        0x0004,  // DpadLeft
+        0x0008,  // DpadRight
+        0x0010,  // GamepadStart
+        0x0020,  // GamepadBack
+        0x0040,  // GamepadLS
+        0x0080,  // GamepadRS
+        0x0100,  // GamepadLB
+        0x0200,  // GamepadRB
+        0x1000,  // GamepadA
+        0x2000,  // GamepadB
+        0x4000,  // GamepadX
+        0x8000,  // GamepadY
+        0x0009,  // GamepadLT
+        0x000a,  // GamepadRT
+    };
+    for (uint32_t i = 0; i < masks.size(); i++) {
+        if (masks[i] == mask) {
+            return kGamepadKeycodeOffset + i;
+        }
+    }
+    return 0;
+}
+
 constexpr uint32_t
-KeycodeFromScancode(uint32_t scancode, RE::INPUT_DEVICE device) {
+KeycodeFromScancode(uint32_t scancode, InputDevice device) {
     switch (device) {
-        case RE::INPUT_DEVICE::kKeyboard:
+        case InputDevice::kKeyboard:
             return scancode;
-        case RE::INPUT_DEVICE::kMouse:
-            return scancode + SKSE::InputMap::kMacro_MouseButtonOffset;
-        case RE::INPUT_DEVICE::kGamepad:
-            return SKSE::InputMap::GamepadMaskToKeycode(scancode);
+        case InputDevice::kMouse:
+            return scancode + kMouseKeycodeOffset;
+        case InputDevice::kGamepad:
+            return KeycodeFromGamepadMask(scancode);
+        default:
+            return 0;
     }
-    return 0;
 }
 
 /// A button press action.
@@ -336,26 +605,6 @@ KeycodeFromScancode(uint32_t scancode, RE::INPUT_DEVICE device) {
 /// - `heldsecs_` is nonnegative and finite.
 class Keystroke final {
   public:
-    static void
-    InputEventsToBuffer(const RE::InputEvent* events, std::vector<Keystroke>& buf) {
-        for (; events; events = events->next) {
-            auto keystroke = FromInputEvent(*events);
-            if (keystroke) {
-                buf.push_back(std::move(*keystroke));
-            }
-        }
-    }
-
-    static std::optional<Keystroke>
-    FromInputEvent(const RE::InputEvent& event) {
-        const auto* button = event.AsButtonEvent();
-        if (!button || !button->HasIDCode() || !button->IsPressed()) {
-            return std::nullopt;
-        }
-        auto keycode = KeycodeFromScancode(button->GetIDCode(), button->GetDevice());
-        return New(keycode, button->HeldDuration());
-    }
-
     static constexpr std::optional<Keystroke>
     New(uint32_t keycode, float heldsecs) {
         constexpr auto inf = std::numeric_limits<float>::infinity();
@@ -423,19 +672,81 @@ enum class Keypress {
     kHold,
 };
 
+/// Classifies a keyset match by how long its most recently pressed key has been held.
+constexpr Keypress
+KeypressFromHeldsecs(float min_heldsecs) {
+    if (min_heldsecs >= kKeypressHoldThreshold) {
+        return Keypress::kHold;
+    } else if (min_heldsecs > 0.f) {
+        return Keypress::kSemihold;
+    } else {
+        return Keypress::kPress;
+    }
+}
+
+/// One bit per keycode in `kKeycodeNames`.
+using KeycodeMask = std::bitset<kKeycodeNames.size()>;
+
+/// Keystrokes from a single input frame, folded into a form that keysets can be matched against
+/// with a few bitwise operations.
+class KeystrokeFrame final {
+  public:
+    /// Replaces the frame's contents with `keystrokes`. If a keycode occurs more than once, the
+    /// first occurrence wins.
+    void
+    Fold(std::span<const Keystroke> keystrokes) {
+        pressed_.reset();
+        for (const auto& keystroke : keystrokes) {
+            auto keycode = keystroke.keycode();
+            if (!pressed_.test(keycode)) {
+                pressed_.set(keycode);
+                heldsecs_[keycode] = keystroke.heldsecs();
+            }
+        }
+    }
+
+    bool
+    empty() const {
+        return pressed_.none();
+    }
+
+    const KeycodeMask&
+    pressed() const {
+        return pressed_;
+    }
+
+    /// Only meaningful if `keycode` is set in `pressed()`.
+    float
+    heldsecs(uint32_t keycode) const {
+        return heldsecs_[keycode];
+    }
+
+  private:
+    KeycodeMask pressed_;
+    std::array<float, kKeycodeNames.size()> heldsecs_{};
+};
+
 /// An ordered collection of 0 or more keysets.
 ///
 /// Invariants:
 /// - No keyset is empty.
 /// - All keysets are normalized.
+/// - `masks_[i]` has exactly the bits of `keysets_[i]`'s valid keycodes set.
 class Keysets final {
   public:
     Keysets() = default;
 
     explicit Keysets(std::vector<Keyset> keysets) : keysets_(std::move(keysets)) {
         std::erase_if(keysets_, KeysetIsEmpty);
+        masks_.reserve(keysets_.size());
         for (auto& keyset : keysets_) {
             keyset = KeysetNormalized(keyset);
+            auto& mask = masks_.emplace_back();
+            for (auto keycode : keyset) {
+                if (KeycodeIsValid(keycode)) {
+                    mask.set(keycode);
+                }
+            }
         }
     }
 
@@ -446,53 +757,44 @@ class Keysets final {
 
     /// Finds the first keyset matching `keystrokes`, then returns the nature of that
     /// match.
+    ///
+    /// When matching several `Keysets` against the same keystrokes, prefer folding them into a
+    /// `KeystrokeFrame` once and calling the `KeystrokeFrame` overload.
     Keypress
     Match(std::span<const Keystroke> keystrokes) const {
-        for (const auto& keyset : keysets_) {
-            auto res = MatchOne(keyset, keystrokes);
-            if (res != Keypress::kNone) {
-                return res;
-            }
+        if (keysets_.empty() || keystrokes.empty()) {
+            return Keypress::kNone;
         }
-        return Keypress::kNone;
+        auto frame = KeystrokeFrame();
+        frame.Fold(keystrokes);
+        return Match(frame);
     }
 
-  private:
-    static Keypress
-    MatchOne(const Keyset& keyset, std::span<const Keystroke> keystrokes) {
-        constexpr auto inf = std::numeric_limits<float>::infinity();
-        auto min_heldsecs = inf;
-        for (auto keycode : keyset) {
-            if (!KeycodeIsValid(keycode)) {
-                // keyset is sorted, no more valid keycodes to look at.
-                break;
-            }
-
-            auto keystroke_is_matching = [=](const Keystroke& keystroke) {
-                return keystroke.keycode() == keycode;
-            };
-            auto it = std::find_if(keystrokes.cbegin(), keystrokes.cend(), keystroke_is_matching);
-            if (it == keystrokes.cend()) {
-                // Current keyset keycode does not match any keystroke.
-                return Keypress::kNone;
+    /// Finds the first keyset whose keycodes are all pressed in `frame`, then returns the nature of
+    /// that match.
+    Keypress
+    Match(const KeystrokeFrame& frame) const {
+        const auto& pressed = frame.pressed();
+        for (size_t i = 0; i < keysets_.size(); i++) {
+            if ((masks_[i] & pressed) != masks_[i]) {
+                continue;
             }
-            if (it->heldsecs() < min_heldsecs) {
-                min_heldsecs = it->heldsecs();
+            auto min_heldsecs = std::numeric_limits<float>::infinity();
+            for (auto keycode : keysets_[i]) {
+                if (!KeycodeIsValid(keycode)) {
+                    // keyset is sorted, no more valid keycodes to look at.
+                    break;
+                }
+                min_heldsecs = std::min(min_heldsecs, frame.heldsecs(keycode));
             }
+            return KeypressFromHeldsecs(min_heldsecs);
         }
-
-        if (min_heldsecs == inf) {
-            return Keypress::kNone;
-        } else if (min_heldsecs >= kKeypressHoldThreshold) {
-            return Keypress::kHold;
-        } else if (min_heldsecs > 0.f) {
-            return Keypress::kSemihold;
-        } else {
-            return Keypress::kPress;
-        }
+        return Keypress::kNone;
     }
 
+  private:
     std::vector<Keyset> keysets_;
+    std::vector<KeycodeMask> masks_;
 };
 
 }  // namespace esas
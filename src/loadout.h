@@ -0,0 +1,230 @@
+// Named sets of spell assignments, saved to files.
+#pragma once
+
+#include "fs.h"
+#include "keys.h"
+#include "serde.h"
+#include "shout_slots.h"
+
+namespace esas {
+
+/// A spell, identified in a way that survives load order changes.
+struct LoadoutSpell final {
+    /// Plugin that defines the spell. Empty for dynamic forms, in which case `id` is the full form
+    /// ID.
+    std::string modname;
+    /// Form ID local to `modname`.
+    uint32_t id = 0;
+
+    bool operator==(const LoadoutSpell&) const = default;
+};
+
+/// Spells to assign, in the order they're assigned. Which shout each spell goes to is not recorded,
+/// since that depends on which slots are free when the loadout is applied.
+struct Loadout final {
+    std::vector<LoadoutSpell> spells;
+
+    bool operator==(const Loadout&) const = default;
+};
+
+inline void
+tag_invoke(
+    const boost::json::value_from_tag&,
+    boost::json::value& jv,
+    const Loadout& loadout,
+    const SerdeContext&
+) {
+    auto ja = boost::json::array();
+    ja.reserve(loadout.spells.size());
+    for (const auto& spell : loadout.spells) {
+        auto jo = boost::json::object();
+        jo["mod"] = boost::json::string_view(spell.modname);
+        jo["id"] = spell.id;
+        ja.push_back(std::move(jo));
+    }
+    auto jo = boost::json::object();
+    jo["spells"] = std::move(ja);
+    jv = std::move(jo);
+}
+
+/// Entries that aren't `{"mod": string, "id": number}` are skipped, so that one bad entry in a
+/// hand-edited file doesn't discard the whole loadout.
+inline boost::json::result<Loadout>
+tag_invoke(
+    const boost::json::try_value_to_tag<Loadout>&,
+    const boost::json::value& jv,
+    const SerdeContext& ctx
+) {
+    const auto* jo = jv.if_object();
+    if (!jo) {
+        return boost::json::make_error_code(boost::json::error::not_object);
+    }
+    auto loadout = Loadout();
+    const auto* spells = jo->if_contains("spells");
+    const auto* ja = spells ? spells->if_array() : nullptr;
+    if (!ja) {
+        return loadout;
+    }
+
+    loadout.spells.reserve(ja->size());
+    for (const auto& elem : *ja) {
+        const auto* entry = elem.if_object();
+        if (!entry) {
+            continue;
+        }
+        auto modname = internal::GetSerObjField<std::string>(*entry, "mod", ctx);
+        auto id = internal::GetSerObjField<uint32_t>(*entry, "id", ctx);
+        if (modname && id) {
+            loadout.spells.push_back({.modname = std::move(*modname), .id = *id});
+        }
+    }
+    return loadout;
+}
+
+namespace internal {
+
+inline constexpr std::string_view kLoadoutExt = ".json";
+
+/// Returns the path of the file holding loadout `name` in `dir`.
+inline std::string
+LoadoutPath(std::string_view dir, std::string_view name) {
+    return std::format("{}/{}{}", dir, name, kLoadoutExt);
+}
+
+/// Whether Windows reserves `stem` (a filename up to its first dot) for a device, e.g. `CON` or
+/// `com1`. Such names open the device instead of a file, whatever the extension.
+inline bool
+IsReservedDeviceName(std::string_view stem) {
+    for (auto device : {"CON", "PRN", "AUX", "NUL"}) {
+        if (AsciiIEquals(stem, device)) {
+            return true;
+        }
+    }
+    auto prefix = stem.substr(0, 3);
+    return stem.size() == 4 && (AsciiIEquals(prefix, "COM") || AsciiIEquals(prefix, "LPT"))
+           && stem[3] >= '1' && stem[3] <= '9';
+}
+
+}  // namespace internal
+
+/// Turns `s` (e.g. a character name) into a loadout name that is safe to use as a filename on
+/// Windows. Characters that Windows doesn't allow in filenames become `_`, and reserved device
+/// names (e.g. `CON`, `nul.txt`) get a `_` prefix. Non-ASCII text is kept.
+inline std::string
+LoadoutNameFromStr(std::string_view s) {
+    constexpr auto reserved = std::string_view(R"(<>:"/\|?*)");
+
+    auto name = std::string(s);
+    for (auto& c : name) {
+        if (static_cast<unsigned char>(c) < 0x20 || reserved.contains(c)) {
+            c = '_';
+        }
+    }
+    // Windows silently drops trailing dots and spaces, and leading ones are easy to miss.
+    auto first = name.find_first_not_of(". ");
+    if (first == std::string::npos) {
+        return "_";
+    }
+    name.erase(name.find_last_not_of(". ") + 1);
+    name.erase(0, first);
+
+    auto stem = std::string_view(name).substr(0, name.find('.'));
+    stem = stem.substr(0, stem.find_last_not_of(' ') + 1);
+    return internal::IsReservedDeviceName(stem) ? "_" + name : name;
+}
+
+/// Writes loadout `name` to `dir`, replacing any existing loadout of that name. Creates `dir` if
+/// needed. `name` should come from `LoadoutNameFromStr()`. Returns false on failure.
+[[nodiscard]] inline bool
+SaveLoadout(std::string_view dir, std::string_view name, const Loadout& loadout) {
+    return fs::WriteFile(internal::LoadoutPath(dir, name), Serialize(loadout));
+}
+
+/// Returns nullopt if loadout `name` doesn't exist in `dir` or cannot be parsed.
+inline std::optional<Loadout>
+LoadLoadout(std::string_view dir, std::string_view name) {
+    return fs::FileContents::Read(internal::LoadoutPath(dir, name))
+        .and_then([](const fs::FileContents& contents) {
+            return Deserialize<Loadout>(contents.view());
+        });
+}
+
+/// Returns the names of all loadouts in `dir`, sorted. A nonexistent `dir` has no loadouts. Returns
+/// nullopt on failure.
+inline std::optional<std::vector<std::string>>
+ListLoadouts(std::string_view dir) {
+    auto names = std::vector<std::string>();
+    if (!fs::ListDirToBuf(dir, names)) {
+        return std::nullopt;
+    }
+    std::erase_if(names, [](const std::string& filename) {
+        return filename.size() <= internal::kLoadoutExt.size()
+               || !filename.ends_with(internal::kLoadoutExt);
+    });
+    for (auto& name : names) {
+        name.resize(name.size() - internal::kLoadoutExt.size());
+    }
+    std::ranges::sort(names);
+    return names;
+}
+
+/// Changes that turn a set of slots' assignments into a loadout's. Slots are only counted as
+/// assigned if the player has their shout.
+///
+/// Applying a diff touches as few of the player's shouts as possible: slots that would be freed are
+/// handed straight to new spells, so their shouts never leave the player's inventory.
+template <FormLike Spell>
+struct LoadoutDiff final {
+    /// `(slot, spell)`: slot holds a spell not in the loadout, and is to be given `spell` instead.
+    /// The player keeps the slot's shout.
+    std::vector<std::pair<size_t, Spell*>> reassign;
+    /// Slots holding a spell not in the loadout, left over after `reassign`. Their shouts are to be
+    /// taken from the player.
+    std::vector<size_t> unassign;
+    /// Loadout spells left over after `reassign`, in loadout order. Each needs a slot whose shout
+    /// is given to the player.
+    std::vector<Spell*> assign;
+};
+
+/// Loadout spells that are already assigned are left alone. Null and repeated spells in `loadout`
+/// are ignored.
+///
+/// A spell whose slot is assigned but unowned (the player somehow lost the shout) goes in
+/// `LoadoutDiff::assign` rather than `reassign`, so that it returns to its old slot instead of
+/// being assigned twice.
+///
+/// Uses linear scans over `loadout`, since loadouts hold a few dozen spells at most.
+template <FormLike Shout, FormLike Spell, std::regular Profile>
+LoadoutDiff<Spell>
+DiffLoadout(const ShoutSlots<Shout, Spell, Profile>& slots, const std::vector<Spell*>& loadout) {
+    auto diff = LoadoutDiff<Spell>();
+    auto freed = std::vector<size_t>();
+    for (size_t i = 0; i < slots.size(); i++) {
+        auto* spell = slots.spells()[i];
+        if (spell && slots.owned(i) && std::ranges::find(loadout, spell) == loadout.end()) {
+            freed.push_back(i);
+        }
+    }
+
+    auto next_freed = freed.begin();
+    for (size_t k = 0; k < loadout.size(); k++) {
+        auto* spell = loadout[k];
+        if (!spell || std::ranges::find(loadout.begin(), loadout.begin() + k, spell)
+                          != loadout.begin() + k) {
+            continue;
+        }
+        auto i = slots.IndexOf(*spell);
+        if (i < slots.size() && slots.owned(i)) {
+            continue;
+        }
+        if (i >= slots.size() && next_freed != freed.end()) {
+            diff.reassign.emplace_back(*next_freed++, spell);
+        } else {
+            diff.assign.push_back(spell);
+        }
+    }
+    diff.unassign.assign(next_freed, freed.end());
+    return diff;
+}
+
+}  // namespace esas
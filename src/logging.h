@@ -0,0 +1,37 @@
+// Logging macros for verbose messages that can be compiled out.
+//
+// `ESAS_ACTIVE_LOG_LEVEL` mirrors `SPDLOG_ACTIVE_LEVEL`: it takes one of the `SPDLOG_LEVEL_*`
+// values, and `ESAS_LOG_TRACE`/`ESAS_LOG_DEBUG` calls below it expand to nothing, arguments
+// included. Otherwise they log to the default logger, still subject to its runtime level. Messages
+// at info and above always go through `SKSE::log` or `spdlog` directly.
+#pragma once
+
+#ifndef ESAS_ACTIVE_LOG_LEVEL
+#define ESAS_ACTIVE_LOG_LEVEL SPDLOG_LEVEL_TRACE
+#endif
+
+/// Logs to the default logger with the caller's source location, like `SKSE::log` does.
+#define ESAS_LOG_CALL(level, ...) \
+    SPDLOG_LOGGER_CALL(spdlog::default_logger_raw(), level, __VA_ARGS__)
+
+#if ESAS_ACTIVE_LOG_LEVEL <= SPDLOG_LEVEL_TRACE
+#define ESAS_LOG_TRACE(...) ESAS_LOG_CALL(spdlog::level::trace, __VA_ARGS__)
+#else
+#define ESAS_LOG_TRACE(...) (void)0
+#endif
+
+#if ESAS_ACTIVE_LOG_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define ESAS_LOG_DEBUG(...) ESAS_LOG_CALL(spdlog::level::debug, __VA_ARGS__)
+#else
+#define ESAS_LOG_DEBUG(...) (void)0
+#endif
+
+namespace esas {
+
+/// Whether messages at `level` can be logged at all in this build.
+constexpr bool
+LogLevelCompiledIn(spdlog::level::level_enum level) {
+    return level >= ESAS_ACTIVE_LOG_LEVEL;
+}
+
+}  // namespace esas
@@ -1,30 +1,140 @@
 // SKSE plugin entry point.
+#include "cosave.h"
 #include "event_handlers.h"
+#include "forms.h"
 #include "fs.h"
-#include "serde.h"
+#include "input.h"
+#include "loadout.h"
+#include "logging.h"
+#include "metrics.h"
+#include "rcu.h"
 #include "settings.h"
+#include "settings_parser.h"
+#include "settings_watcher.h"
+#include "shout_set.h"
 #include "shoutmap.h"
 
 namespace {
 
 using namespace esas;
 
+/// Settings as of startup. Used for everything that can't change without a restart.
 auto gSettings = Settings();
+/// Latest settings, for the handlers. Updated in place of `gSettings` on hot-reload.
+auto gSettingsSnapshot = Rcu<Settings>();
+/// Guards `gShoutmap`. Never taken on the casting path.
 auto gMutex = std::mutex();
+/// Writable shoutmap. After every change, a copy must be published to `gShoutmapSnapshot`.
 auto gShoutmap = Shoutmap();
+/// Read-only view of `gShoutmap` for the casting path.
+auto gShoutmapSnapshot = Rcu<Shoutmap>();
 
+/// Set once handlers are initialized on `kDataLoaded`.
+InputDispatcher* gInputDispatcher = nullptr;
+/// Scratch space for cosave records. Guarded by `gMutex`.
+auto gCosaveBuf = std::vector<std::byte>();
+/// Non-null iff metrics are enabled.
+std::unique_ptr<metrics::PeriodicReporter> gMetricsReporter;
+/// Non-null iff settings hot-reload is enabled.
+std::unique_ptr<SettingsWatcher> gSettingsWatcher;
+/// Startup phases and their durations, since the last `LogStartupPhases()`.
+auto gStartupPhases = std::vector<std::pair<std::string_view, std::chrono::microseconds>>();
+
+/// Records the time from construction to destruction as a startup phase.
+class StartupPhase final {
+  public:
+    explicit StartupPhase(std::string_view name)
+        : name_(name),
+          start_(std::chrono::steady_clock::now()) {}
+
+    StartupPhase(const StartupPhase&) = delete;
+    StartupPhase& operator=(const StartupPhase&) = delete;
+    StartupPhase(StartupPhase&&) = delete;
+    StartupPhase& operator=(StartupPhase&&) = delete;
+
+    ~StartupPhase() {
+        gStartupPhases.emplace_back(
+            name_,
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start_
+            )
+        );
+    }
+
+  private:
+    std::string_view name_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+void
+LogStartupPhases(std::string_view stage) {
+    auto line = std::string();
+    for (const auto& [name, duration] : gStartupPhases) {
+        line += std::format(" {}={}us", name, duration.count());
+    }
+    SKSE::log::info("{} timings:{}", stage, line);
+    gStartupPhases.clear();
+}
+
+/// Caller must hold `gMutex`.
+void
+PublishShoutmap() {
+    gShoutmapSnapshot.Publish(std::make_unique<const Shoutmap>(gShoutmap));
+}
+
+struct LoadedSettings {
+    /// Nullopt if the settings file can't be read or parsed.
+    std::optional<Settings> settings;
+    std::chrono::microseconds read_time{};
+    std::chrono::microseconds parse_time{};
+};
+
+/// Thread-safe. Does not log, since logging isn't set up until settings are loaded.
+LoadedSettings
+LoadSettings() {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    using std::chrono::steady_clock;
+
+    auto loaded = LoadedSettings();
+    auto t0 = steady_clock::now();
+    auto contents = fs::FileContents::Read(fs::kSettingsPath);
+    auto t1 = steady_clock::now();
+    loaded.read_time = duration_cast<microseconds>(t1 - t0);
+    if (!contents) {
+        return loaded;
+    }
+    loaded.settings = ParseSettings(contents->view());
+    loaded.parse_time = duration_cast<microseconds>(steady_clock::now() - t1);
+    return loaded;
+}
+
+/// Call once logging is set up.
 void
-InitSettings() {
-    auto settings = fs::ReadFile(fs::kSettingsPath).and_then([](std::string&& s) {
-        return Deserialize<Settings>(s);
-    });
-    if (!settings) {
+LogSettingsLoad(const LoadedSettings& loaded) {
+    gStartupPhases.emplace_back("settings_read", loaded.read_time);
+    gStartupPhases.emplace_back("settings_parse", loaded.parse_time);
+    if (!loaded.settings) {
         SKSE::log::warn("'{}' cannot be parsed, using default settings", fs::kSettingsPath);
-        return;
     }
-    gSettings = std::move(*settings);
 }
 
+/// Returns `s` if it's a valid level name, otherwise info.
+spdlog::level::level_enum
+LogLevelFromStr(const std::string& s) {
+    auto level = spdlog::level::from_str(s);
+    if (level == spdlog::level::off && s != "off") {
+        level = spdlog::level::info;
+    }
+    return level;
+}
+
+/// Maximum number of messages awaiting the async logger's worker thread.
+constexpr size_t kAsyncLogQueueSize = 8192;
+
+/// Sets up a synchronous logger for the plugin's log file at info level. Called before SKSE setup,
+/// so that its failures are logged. `ConfigureLogging()` applies the log settings once they're
+/// loaded.
 void
 InitLogging(const SKSE::PluginDeclaration& plugin_decl) {
     auto log_dir = SKSE::log::log_directory();
@@ -35,31 +145,151 @@ InitLogging(const SKSE::PluginDeclaration& plugin_decl) {
 
     auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(log_dir->string(), true);
     auto logger = std::make_shared<spdlog::logger>("logger", std::move(sink));
+    logger->flush_on(spdlog::level::info);
+    logger->set_level(spdlog::level::info);
+    // https://github.com/gabime/spdlog/wiki/3.-Custom-formatting#pattern-flags
+    logger->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%l] [%t] [%s:%#] %v");
+    spdlog::set_default_logger(std::move(logger));
+}
 
-    auto level = spdlog::level::from_str(gSettings.log_level);
-    if (level == spdlog::level::off && gSettings.log_level != "off") {
-        level = spdlog::level::info;
+/// Applies `gSettings.log_level` and `gSettings.log_async` to the logger from `InitLogging()`. An
+/// async logger takes over the same file sink, so nothing logged so far is lost.
+void
+ConfigureLogging() {
+    auto logger = spdlog::default_logger();
+    if (gSettings.log_async) {
+        const auto& sinks = logger->sinks();
+        // One worker thread keeps messages in order. Never block the game thread on a full queue.
+        spdlog::init_thread_pool(kAsyncLogQueueSize, 1);
+        logger = std::make_shared<spdlog::async_logger>(
+            "logger",
+            sinks.begin(),
+            sinks.end(),
+            spdlog::thread_pool(),
+            spdlog::async_overflow_policy::overrun_oldest
+        );
     }
+
+    auto level = LogLevelFromStr(gSettings.log_level);
     logger->flush_on(level);
     logger->set_level(level);
-    // https://github.com/gabime/spdlog/wiki/3.-Custom-formatting#pattern-flags
-    logger->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%l] [%t] [%s:%#] %v");
 
     spdlog::set_default_logger(std::move(logger));
+    if (!LogLevelCompiledIn(level)) {
+        SKSE::log::info(
+            "log level '{}' requested, but this build omits messages below '{}'",
+            gSettings.log_level,
+            spdlog::level::to_string_view(
+                static_cast<spdlog::level::level_enum>(ESAS_ACTIVE_LOG_LEVEL)
+            )
+        );
+    }
+}
+
+void
+LogMetrics(const std::vector<std::string>& lines) {
+    for (const auto& line : lines) {
+        SKSE::log::info("metrics: {}", line);
+    }
+}
+
+void
+InitMetrics() {
+    if (!(gSettings.metrics_interval_secs > 0.f)) {
+        return;
+    }
+    auto interval = std::chrono::milliseconds(
+        static_cast<int64_t>(std::max(gSettings.metrics_interval_secs, 1.f) * 1000.f)
+    );
+    metrics::gRegistry.SetEnabled(true);
+    gMetricsReporter =
+        std::make_unique<metrics::PeriodicReporter>(metrics::gRegistry, interval, LogMetrics);
+    SKSE::log::info("metrics enabled, reporting every {}ms", interval.count());
+}
+
+/// Runs on the settings watcher's thread.
+void
+OnSettingsReload(const Settings& settings) {
+    auto level = LogLevelFromStr(settings.log_level);
+    if (auto* logger = spdlog::default_logger_raw()) {
+        logger->flush_on(level);
+        logger->set_level(level);
+    }
+    SKSE::log::info("settings reloaded from '{}'", fs::kSettingsPath);
+}
+
+void
+InitSettingsWatcher() {
+    gSettingsSnapshot.Publish(std::make_unique<const Settings>(gSettings));
+    if (!(gSettings.settings_reload_secs > 0.f)) {
+        return;
+    }
+    auto interval = std::chrono::milliseconds(
+        static_cast<int64_t>(std::max(gSettings.settings_reload_secs, 1.f) * 1000.f)
+    );
+    gSettingsWatcher = std::make_unique<SettingsWatcher>(
+        std::string(fs::kSettingsPath), gSettingsSnapshot, interval, OnSettingsReload
+    );
+    SKSE::log::info("settings hot-reload enabled, checking every {}ms", interval.count());
+}
+
+void
+InitHandlers() {
+    {
+        auto phase = StartupPhase("resolve_forms");
+        ResolvedForms::Refresh();
+    }
+    {
+        auto phase = StartupPhase("shoutmap");
+        auto lock = std::lock_guard(gMutex);
+        gShoutmap = Shoutmap::New();
+        PublishShoutmap();
+    }
+    {
+        auto phase = StartupPhase("handlers");
+        gInputDispatcher = InputDispatcher::Init();
+        if (!gInputDispatcher) {
+            SKSE::stl::report_and_fail("cannot initialize input dispatcher");
+        }
+        InitSettingsWatcher();
+        if (!FafHandler::Init(gShoutmapSnapshot, gSettingsSnapshot)
+            || !ConcHandler::Init(*gInputDispatcher, gShoutmapSnapshot, gSettingsSnapshot)
+            || !AssignmentHandler::Init(
+                *gInputDispatcher, gMutex, gShoutmap, gShoutmapSnapshot, gSettingsSnapshot
+            )) {
+            SKSE::stl::report_and_fail("cannot initialize fire-and-forget handler");
+        }
+        InitMetrics();
+    }
+    LogStartupPhases("data loaded");
+
+    if (auto loadouts = ListLoadouts(fs::kLoadoutsDir)) {
+        SKSE::log::info("{} loadout(s) found in '{}'", loadouts->size(), fs::kLoadoutsDir);
+        for (const auto& name : *loadouts) {
+            ESAS_LOG_DEBUG("loadout '{}'", name);
+        }
+    } else {
+        SKSE::log::warn("cannot list loadouts in '{}'", fs::kLoadoutsDir);
+    }
 }
 
 void
 InitSKSEMessaging(const SKSE::MessagingInterface& mi) {
     constexpr auto listener = [](SKSE::MessagingInterface::Message* msg) -> void {
-        if (!msg || msg->type != SKSE::MessagingInterface::kDataLoaded) {
+        if (!msg) {
             return;
         }
-
-        gShoutmap = Shoutmap::New();
-        if (!FafHandler::Init(gMutex, gShoutmap, gSettings)
-            || !ConcHandler::Init(gMutex, gShoutmap, gSettings)
-            || !AssignmentHandler::Init(gMutex, gShoutmap, gSettings)) {
-            SKSE::stl::report_and_fail("cannot initialize fire-and-forget handler");
+        switch (msg->type) {
+            case SKSE::MessagingInterface::kDataLoaded:
+                InitHandlers();
+                break;
+            case SKSE::MessagingInterface::kPostLoadGame:
+            case SKSE::MessagingInterface::kNewGame:
+                // Controls may have been remapped since the shout button mapping was cached.
+                if (gInputDispatcher) {
+                    gInputDispatcher->InvalidateControlMap();
+                }
+                break;
         }
     };
 
@@ -80,14 +310,20 @@ InitSKSESerialization(const SKSE::SerializationInterface& si) {
             return;
         }
 
+        if (metrics::gRegistry.enabled()) {
+            LogMetrics(metrics::gRegistry.Report());
+        }
+
         auto lock = std::lock_guard(gMutex);
-        auto ir = ShoutmapToIR(gShoutmap, *player);
-        if (ir.empty()) {
+        auto owned = ShoutSet(tes_util::GetShouts(*player));
+        auto ir = ShoutmapToIR(gShoutmap, owned);
+        // Even with no assignments, a record is needed if the player has any of this mod's dynamic
+        // shouts, so that on_load runs and prunes them.
+        if (ir.empty() && !OwnsDynamicShouts(owned)) {
             return;
         }
-        auto s = Serialize(ir);
-        if (si->WriteRecord('ESAS', 1, s.c_str(), static_cast<uint32_t>(s.size()))) {
-            SKSE::log::debug("spell shout assignments serialized to SKSE cosave");
+        if (cosave::SaveShoutmapIR(*si, ir, gCosaveBuf)) {
+            ESAS_LOG_DEBUG("spell shout assignments serialized to SKSE cosave");
         } else {
             SKSE::log::error("cannot serialize spell shout assignments to SKSE cosave");
         }
@@ -105,45 +341,17 @@ InitSKSESerialization(const SKSE::SerializationInterface& si) {
 
         auto lock = std::lock_guard(gMutex);
         gShoutmap = Shoutmap::New();
-        uint32_t type;
-        uint32_t version;  // unused
-        uint32_t length;
-        while (si->GetNextRecordInfo(type, version, length)) {
-            if (type != 'ESAS') {
-                SKSE::log::warn("unknown record type '{}' in SKSE cosave", type);
-                continue;
-            }
-
-            std::string s;
-            s.reserve(length);
-            for (uint32_t i = 0; i < length; i++) {
-                char c;
-                si->ReadRecordData(&c, 1);
-                s.push_back(c);
-            }
-
-            auto ir = Deserialize<ShoutmapIR>(s);
-            if (!ir) {
-                SKSE::log::error("cannot deserialize spell shout assignments from SKSE cosave");
-                continue;
-            }
-            for (auto& pair : *ir) {
-                auto new_spell_id = RE::FormID();
-                if (si->ResolveFormID(pair.second, new_spell_id)) {
-                    pair.second = new_spell_id;
-                    continue;
-                }
-                SKSE::log::warn("cannot resolve old form ID {:08X}", pair.second);
-                pair.second = 0;
-            }
-            std::erase_if(*ir, [](const std::pair<RE::FormID, RE::FormID>& pair) {
-                return pair.second == 0;
-            });
-
-            if (ShoutmapFillFromIR(gShoutmap, *ir, *player) > 0) {
-                SKSE::log::debug("spell power assignments loaded from SKSE cosave");
-            }
+        auto ir = cosave::LoadShoutmapIR(*si, gCosaveBuf);
+        // on_save writes a record whenever the player has any of this mod's dynamic shouts, so this
+        // callback runs for every save that needs pruning.
+        if (auto pruned = PruneSavedDynamicShouts(*player)) {
+            ESAS_LOG_DEBUG("removed {} saved dynamic shout(s) from player", pruned);
         }
+        auto owned = ShoutSet(tes_util::GetShouts(*player));
+        if (ShoutmapFillFromIR(gShoutmap, ir, *player, owned) > 0) {
+            ESAS_LOG_DEBUG("spell power assignments loaded from SKSE cosave");
+        }
+        PublishShoutmap();
     };
 
     static constexpr auto on_revert = [](SKSE::SerializationInterface* si) -> void {
@@ -152,9 +360,10 @@ InitSKSESerialization(const SKSE::SerializationInterface& si) {
         }
         auto lock = std::lock_guard(gMutex);
         gShoutmap = Shoutmap::New();
+        PublishShoutmap();
     };
 
-    si.SetUniqueID('ESAS');
+    si.SetUniqueID(RecordType("ESAS"));
     si.SetSaveCallback(on_save);
     si.SetLoadCallback(on_load);
     si.SetRevertCallback(on_revert);
@@ -168,21 +377,45 @@ SKSEPluginLoad(const SKSE::LoadInterface* skse) {
         SKSE::stl::report_and_fail("cannot get SKSE plugin declaration");
     }
 
-    InitSettings();
-    InitLogging(*plugin_decl);
-    SKSE::Init(skse);
-
-    const auto* mi = SKSE::GetMessagingInterface();
-    const auto* si = SKSE::GetSerializationInterface();
-    if (!mi) {
-        SKSE::stl::report_and_fail("cannot get SKSE messaging interface");
+    {
+        auto phase = StartupPhase("logging");
+        InitLogging(*plugin_decl);
     }
-    if (!si) {
-        SKSE::stl::report_and_fail("cannot get SKSE serialization interface");
+
+    // File I/O and parsing overlap with SKSE setup, which doesn't depend on settings.
+    auto loading_settings = std::async(std::launch::async, LoadSettings);
+    {
+        auto phase = StartupPhase("skse_init");
+        SKSE::Init(skse);
+
+        const auto* mi = SKSE::GetMessagingInterface();
+        const auto* si = SKSE::GetSerializationInterface();
+        if (!mi) {
+            SKSE::stl::report_and_fail("cannot get SKSE messaging interface");
+        }
+        if (!si) {
+            SKSE::stl::report_and_fail("cannot get SKSE serialization interface");
+        }
+
+        InitSKSEMessaging(*mi);
+        InitSKSESerialization(*si);
     }
 
-    InitSKSEMessaging(*mi);
-    InitSKSESerialization(*si);
+    // Join point: nothing before here may read `gSettings`.
+    auto loaded = LoadedSettings();
+    {
+        auto phase = StartupPhase("settings_wait");
+        loaded = loading_settings.get();
+    }
+    if (loaded.settings) {
+        gSettings = std::move(*loaded.settings);
+    }
+    {
+        auto phase = StartupPhase("log_config");
+        ConfigureLogging();
+    }
+    LogSettingsLoad(loaded);
+    LogStartupPhases("plugin load");
 
     SKSE::log::info(
         "{} {}.{}.{} loaded",
@@ -0,0 +1,269 @@
+// Opt-in latency histograms and event counters for the event handlers.
+#pragma once
+
+#include "periodic_thread.h"
+
+namespace esas {
+namespace metrics {
+
+/// A timed code path.
+enum class Probe : size_t {
+    kInputDispatch,
+    kFafAction,
+    kConcAction,
+    kConcInput,
+    kAssignmentInput,
+    kCount,
+};
+
+inline constexpr auto kProbeNames =
+    std::array<std::string_view, std::to_underlying(Probe::kCount)>{
+        "input_dispatch",
+        "faf_action",
+        "conc_action",
+        "conc_input",
+        "assignment_input",
+    };
+
+enum class Counter : size_t {
+    /// Shoutmap lookups on the casting path.
+    kLookups,
+    /// Times the assignment handler found the shoutmap mutex already taken.
+    kMutexWaits,
+    kCasts,
+    /// Casts abandoned after the shout was recognized as a spell shout, e.g. for lack of magicka.
+    kAbortedCasts,
+    kCount,
+};
+
+inline constexpr auto kCounterNames =
+    std::array<std::string_view, std::to_underlying(Counter::kCount)>{
+        "lookups",
+        "mutex_waits",
+        "casts",
+        "aborted_casts",
+    };
+
+/// Lock-free histogram of durations. Bucket `i` counts durations in `[2^(i-1), 2^i)` nanoseconds
+/// (bucket 0 counts zero-length durations), so percentiles are reported as power-of-2 upper bounds.
+class Histogram final {
+  public:
+    static constexpr size_t kBuckets = 40;
+
+    struct Summary {
+        uint64_t count = 0;
+        uint64_t mean_ns = 0;
+        uint64_t p50_ns = 0;
+        uint64_t p99_ns = 0;
+        uint64_t max_ns = 0;
+    };
+
+    constexpr Histogram() = default;
+
+    Histogram(const Histogram&) = delete;
+    Histogram& operator=(const Histogram&) = delete;
+    Histogram(Histogram&&) = delete;
+    Histogram& operator=(Histogram&&) = delete;
+
+    void
+    Record(uint64_t ns) {
+        auto b = std::min(static_cast<size_t>(std::bit_width(ns)), kBuckets - 1);
+        buckets_[b].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_ns_.fetch_add(ns, std::memory_order_relaxed);
+        auto max = max_ns_.load(std::memory_order_relaxed);
+        while (ns > max && !max_ns_.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {}
+    }
+
+    /// Concurrent `Record()` calls may or may not be reflected.
+    Summary
+    Summarize() const {
+        auto s = Summary{
+            .count = count_.load(std::memory_order_relaxed),
+            .max_ns = max_ns_.load(std::memory_order_relaxed),
+        };
+        if (s.count == 0) {
+            return s;
+        }
+        s.mean_ns = sum_ns_.load(std::memory_order_relaxed) / s.count;
+        s.p50_ns = Percentile(s.count, 50);
+        s.p99_ns = Percentile(s.count, 99);
+        return s;
+    }
+
+    void
+    Reset() {
+        for (auto& b : buckets_) {
+            b.store(0, std::memory_order_relaxed);
+        }
+        count_.store(0, std::memory_order_relaxed);
+        sum_ns_.store(0, std::memory_order_relaxed);
+        max_ns_.store(0, std::memory_order_relaxed);
+    }
+
+  private:
+    uint64_t
+    Percentile(uint64_t count, uint64_t pct) const {
+        auto rank = std::max<uint64_t>((count * pct + 99) / 100, 1);
+        auto seen = uint64_t(0);
+        for (size_t b = 0; b < kBuckets; b++) {
+            seen += buckets_[b].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                return b == 0 ? 0 : uint64_t(1) << b;
+            }
+        }
+        return max_ns_.load(std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+    std::atomic<uint64_t> count_ = 0;
+    std::atomic<uint64_t> sum_ns_ = 0;
+    std::atomic<uint64_t> max_ns_ = 0;
+};
+
+/// Records the lifetime of the timer into a histogram.
+class ScopedTimer final {
+  public:
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+    ScopedTimer(ScopedTimer&&) = delete;
+    ScopedTimer& operator=(ScopedTimer&&) = delete;
+
+    explicit ScopedTimer(Histogram& histogram)
+        : histogram_(histogram),
+          start_(std::chrono::steady_clock::now()) {}
+
+    ~ScopedTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        histogram_.Record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()
+        ));
+    }
+
+  private:
+    Histogram& histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+/// All probes and counters. Disabled by default; while disabled, `Time()` and `Count()` cost a
+/// single relaxed load and a branch that is always predicted correctly.
+class Registry final {
+  public:
+    constexpr Registry() = default;
+
+    Registry(const Registry&) = delete;
+    Registry& operator=(const Registry&) = delete;
+    Registry(Registry&&) = delete;
+    Registry& operator=(Registry&&) = delete;
+
+    bool
+    enabled() const {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    void
+    SetEnabled(bool enabled) {
+        enabled_.store(enabled, std::memory_order_relaxed);
+    }
+
+    /// Returns `f()`, timing it under `probe` if enabled.
+    template <typename F>
+    decltype(auto)
+    Time(Probe probe, F&& f) {
+        if (!enabled()) [[likely]] {
+            return std::forward<F>(f)();
+        }
+        auto timer = ScopedTimer(histogram(probe));
+        return std::forward<F>(f)();
+    }
+
+    /// No-op if disabled.
+    void
+    Count(Counter counter, uint64_t n = 1) {
+        if (enabled()) [[unlikely]] {
+            counters_[std::to_underlying(counter)].fetch_add(n, std::memory_order_relaxed);
+        }
+    }
+
+    Histogram&
+    histogram(Probe probe) {
+        return histograms_[std::to_underlying(probe)];
+    }
+
+    const Histogram&
+    histogram(Probe probe) const {
+        return histograms_[std::to_underlying(probe)];
+    }
+
+    uint64_t
+    count(Counter counter) const {
+        return counters_[std::to_underlying(counter)].load(std::memory_order_relaxed);
+    }
+
+    /// One line per probe that has samples, then one line of counters. Durations are in
+    /// nanoseconds.
+    std::vector<std::string>
+    Report() const {
+        auto lines = std::vector<std::string>();
+        for (size_t i = 0; i < histograms_.size(); i++) {
+            auto s = histograms_[i].Summarize();
+            if (s.count == 0) {
+                continue;
+            }
+            lines.push_back(std::format(
+                "{}: n={} mean={}ns p50<={}ns p99<={}ns max={}ns",
+                kProbeNames[i],
+                s.count,
+                s.mean_ns,
+                s.p50_ns,
+                s.p99_ns,
+                s.max_ns
+            ));
+        }
+        auto counters = std::string("counters:");
+        for (size_t i = 0; i < counters_.size(); i++) {
+            counters += std::format(" {}={}", kCounterNames[i], counters_[i].load());
+        }
+        lines.push_back(std::move(counters));
+        return lines;
+    }
+
+    void
+    Reset() {
+        for (auto& h : histograms_) {
+            h.Reset();
+        }
+        for (auto& c : counters_) {
+            c.store(0, std::memory_order_relaxed);
+        }
+    }
+
+  private:
+    std::atomic<bool> enabled_ = false;
+    std::array<Histogram, std::to_underlying(Probe::kCount)> histograms_{};
+    std::array<std::atomic<uint64_t>, std::to_underlying(Counter::kCount)> counters_{};
+};
+
+/// The registry that the event handlers report to.
+inline constinit auto gRegistry = Registry();
+
+/// Passes `registry.Report()` to `sink` every `interval`, from a background thread, until
+/// destroyed.
+class PeriodicReporter final {
+  public:
+    using Sink = std::function<void(const std::vector<std::string>&)>;
+
+    PeriodicReporter(const PeriodicReporter&) = delete;
+    PeriodicReporter& operator=(const PeriodicReporter&) = delete;
+    PeriodicReporter(PeriodicReporter&&) = delete;
+    PeriodicReporter& operator=(PeriodicReporter&&) = delete;
+
+    PeriodicReporter(const Registry& registry, std::chrono::milliseconds interval, Sink sink)
+        : thread_(interval, [&registry, sink = std::move(sink)]() { sink(registry.Report()); }) {}
+
+  private:
+    PeriodicThread thread_;
+};
+
+}  // namespace metrics
+}  // namespace esas
@@ -5,116 +5,11 @@
 #define UNICODE
 #define _UNICODE
 
-// https://stackoverflow.com/a/2029106
-#include <algorithm>
-#include <any>
-#include <array>
-#include <atomic>
-#include <barrier>
-#include <bit>
-#include <bitset>
-#include <charconv>
-#include <chrono>
+#include "pch_core.h"
+
+// Deprecated, so kept out of the portable set.
 #include <codecvt>
-#include <compare>
-#include <complex>
-#include <concepts>
-#include <condition_variable>
-#include <coroutine>
-#include <deque>
-#include <exception>
-#include <execution>
-#include <expected>
-#include <filesystem>
-// #include <flat_map>
-// #include <flat_set>
-#include <format>
-#include <forward_list>
-#include <fstream>
-#include <functional>
-#include <future>
-// #include <generator>
-#include <initializer_list>
-#include <iomanip>
-#include <ios>
-#include <iosfwd>
-#include <iostream>
-#include <istream>
-#include <iterator>
-#include <latch>
-#include <limits>
-#include <list>
-#include <locale>
-#include <map>
-// #include <mdspan>
-#include <memory>
-#include <memory_resource>
-#include <mutex>
-#include <new>
-#include <numbers>
-#include <numeric>
-#include <optional>
-#include <ostream>
-#include <print>
-#include <queue>
-#include <random>
-#include <ranges>
-#include <ratio>
-#include <regex>
-#include <scoped_allocator>
-#include <semaphore>
-#include <set>
-#include <shared_mutex>
-#include <source_location>
-#include <span>
-#include <spanstream>
-#include <sstream>
-#include <stack>
-#include <stacktrace>
-#include <stdexcept>
-#include <stdfloat>
-#include <stop_token>
-#include <streambuf>
-#include <string>
-#include <string_view>
 #include <strstream>
-#include <syncstream>
-#include <system_error>
-#include <thread>
-#include <tuple>
-#include <type_traits>
-#include <typeindex>
-#include <typeinfo>
-#include <unordered_map>
-#include <unordered_set>
-#include <utility>
-#include <valarray>
-#include <variant>
-#include <vector>
-#include <version>
-
-// https://stackoverflow.com/a/2029106
-#include <cassert>
-#include <cctype>
-#include <cerrno>
-#include <cfenv>
-#include <cfloat>
-#include <cinttypes>
-#include <climits>
-#include <clocale>
-#include <cmath>
-#include <csetjmp>
-#include <csignal>
-#include <cstdarg>
-#include <cstddef>
-#include <cstdint>
-#include <cstdio>
-#include <cstdlib>
-#include <cstring>
-#include <ctime>
-#include <cuchar>
-#include <cwchar>
-#include <cwctype>
 
 // CommonLibSSE
 #include <RE/Skyrim.h>
@@ -124,10 +19,4 @@
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/spdlog.h>
 
-// Serde
-#include <boost/json.hpp>
-
-using namespace std::literals;
 using namespace REL::literals;
-
-#define ESAS_NAME "EquipSpellsAsShouts"
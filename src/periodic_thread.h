@@ -0,0 +1,35 @@
+// Background thread that runs a task at a fixed interval.
+#pragma once
+
+namespace esas {
+
+/// Calls a task every `interval` from a background thread, until destroyed. The first call comes
+/// one interval after construction. Destruction wakes the thread immediately instead of waiting
+/// out the interval, and waits for any call in progress to return.
+class PeriodicThread final {
+  public:
+    PeriodicThread(const PeriodicThread&) = delete;
+    PeriodicThread& operator=(const PeriodicThread&) = delete;
+    PeriodicThread(PeriodicThread&&) = delete;
+    PeriodicThread& operator=(PeriodicThread&&) = delete;
+
+    PeriodicThread(std::chrono::milliseconds interval, std::function<void()> task)
+        : thread_([interval, task = std::move(task), this](std::stop_token st) {
+              auto lock = std::unique_lock(mutex_);
+              while (true) {
+                  cv_.wait_for(lock, st, interval, [] { return false; });
+                  if (st.stop_requested()) {
+                      break;
+                  }
+                  task();
+              }
+          }) {}
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable_any cv_;
+    /// Declared last so that it's joined before anything it uses is destroyed.
+    std::jthread thread_;
+};
+
+}  // namespace esas
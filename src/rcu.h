@@ -0,0 +1,103 @@
+// Read-copy-update cell for data that is read far more often than it is written.
+#pragma once
+
+namespace esas {
+
+/// Holds an immutable `T` that any number of threads can read without locking. Writers replace the
+/// value wholesale with `Publish()`; replaced values are reclaimed once no reader can still be
+/// looking at them.
+///
+/// Reads are wait-free: one atomic increment, one atomic load and one atomic decrement. Reads never
+/// block behind writers, and writers never wait for readers (reclamation is simply deferred to a
+/// later `Publish()` or `Reclaim()` while readers are active).
+template <typename T>
+class Rcu final {
+  public:
+    /// Keeps the value returned by `Rcu::Read()` alive. Must not outlive the `Rcu` it came from.
+    class ReadGuard final {
+      public:
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+        ReadGuard(ReadGuard&&) = delete;
+        ReadGuard& operator=(ReadGuard&&) = delete;
+
+        ~ReadGuard() {
+            readers_.fetch_sub(1, std::memory_order_release);
+        }
+
+        const T&
+        operator*() const {
+            return *value_;
+        }
+
+        const T*
+        operator->() const {
+            return value_;
+        }
+
+      private:
+        friend class Rcu;
+
+        explicit ReadGuard(const Rcu& rcu) : readers_(rcu.readers_) {
+            readers_.fetch_add(1, std::memory_order_seq_cst);
+            value_ = rcu.current_.load(std::memory_order_seq_cst);
+        }
+
+        std::atomic<size_t>& readers_;
+        const T* value_;
+    };
+
+    Rcu(const Rcu&) = delete;
+    Rcu& operator=(const Rcu&) = delete;
+    Rcu(Rcu&&) = delete;
+    Rcu& operator=(Rcu&&) = delete;
+
+    explicit Rcu(std::unique_ptr<const T> initial = std::make_unique<const T>())
+        : current_(initial.release()) {}
+
+    ~Rcu() {
+        delete current_.load();
+    }
+
+    /// Returns a guard to the most recently published value.
+    [[nodiscard]] ReadGuard
+    Read() const {
+        return ReadGuard(*this);
+    }
+
+    /// Replaces the current value. Safe to call concurrently with readers and other writers.
+    void
+    Publish(std::unique_ptr<const T> next) {
+        auto lock = std::lock_guard(writer_mutex_);
+        auto* prev = current_.exchange(next.release(), std::memory_order_seq_cst);
+        retired_.emplace_back(prev);
+        ReclaimLocked();
+    }
+
+    /// Frees replaced values if no reader is active. Returns the number of replaced values still
+    /// awaiting reclamation.
+    size_t
+    Reclaim() {
+        auto lock = std::lock_guard(writer_mutex_);
+        ReclaimLocked();
+        return retired_.size();
+    }
+
+  private:
+    /// A reader that incremented `readers_` after `current_` was swapped is guaranteed to see the
+    /// new value. So if `readers_` is observed to be 0 at any point after the swap, nobody can still
+    /// hold a pointer to a retired value.
+    void
+    ReclaimLocked() {
+        if (readers_.load(std::memory_order_seq_cst) == 0) {
+            retired_.clear();
+        }
+    }
+
+    std::atomic<const T*> current_;
+    mutable std::atomic<size_t> readers_ = 0;
+    std::mutex writer_mutex_;
+    std::vector<std::unique_ptr<const T>> retired_;
+};
+
+}  // namespace esas
@@ -0,0 +1,126 @@
+// Buffered streaming over SKSE cosave records.
+#pragma once
+
+namespace esas {
+
+/// The subset of `SKSE::SerializationInterface` used for cosave I/O. Satisfied by
+/// `SKSE::SerializationInterface` itself, and by in-memory fakes in tests.
+template <typename SI>
+concept SerializationApi = requires(
+    const SI& si, uint32_t& out, uint32_t n, void* dst, const void* src
+) {
+    { si.GetNextRecordInfo(out, out, out) } -> std::convertible_to<bool>;
+    { si.ReadRecordData(dst, n) } -> std::convertible_to<uint32_t>;
+    { si.OpenRecord(n, n) } -> std::convertible_to<bool>;
+    { si.WriteRecordData(src, n) } -> std::convertible_to<bool>;
+    { si.ResolveFormID(n, out) } -> std::convertible_to<bool>;
+};
+
+/// Packs four characters into a record type, with the same value as MSVC gives the multi-character
+/// literal (e.g. `RecordType("ESAS") == 'ESAS'`). Other compilers warn about such literals.
+constexpr uint32_t
+RecordType(const char (&chars)[5]) {
+    return static_cast<uint32_t>(chars[0]) << 24 | static_cast<uint32_t>(chars[1]) << 16
+           | static_cast<uint32_t>(chars[2]) << 8 | static_cast<uint32_t>(chars[3]);
+}
+
+/// Reads the body of the current cosave record, i.e. the one most recently returned by
+/// `GetNextRecordInfo()`. Never reads past the end of the record.
+template <SerializationApi SI>
+class RecordReader final {
+  public:
+    static constexpr uint32_t kDefaultChunkSize = 64 * 1024;
+
+    RecordReader(const RecordReader&) = delete;
+    RecordReader& operator=(const RecordReader&) = delete;
+    RecordReader(RecordReader&&) = delete;
+    RecordReader& operator=(RecordReader&&) = delete;
+
+    /// `length` is the record length reported by `GetNextRecordInfo()`. `buf` backs `ReadAll()`
+    /// and may be shared between readers to reuse its allocation.
+    RecordReader(
+        const SI& si,
+        uint32_t length,
+        std::vector<std::byte>& buf,
+        uint32_t chunk_size = kDefaultChunkSize
+    )
+        : si_(si),
+          remaining_(length),
+          buf_(buf),
+          chunk_size_(std::max(chunk_size, uint32_t(1))) {}
+
+    uint32_t
+    remaining() const {
+        return remaining_;
+    }
+
+    /// Reads up to `dst.size()` bytes. Returns the number of bytes read, which is less than
+    /// `dst.size()` only at the end of the record or on a short read from `SI`.
+    size_t
+    Read(std::span<std::byte> dst) {
+        auto want = static_cast<uint32_t>(std::min<size_t>(dst.size(), remaining_));
+        auto got = std::min(si_.ReadRecordData(dst.data(), want), want);
+        remaining_ -= got;
+        return got;
+    }
+
+    /// Reads the rest of the record into the shared buffer in `chunk_size` pieces. The returned
+    /// span is invalidated by the next `ReadAll()` on any reader sharing the buffer. Returns
+    /// nullopt on a short read.
+    std::optional<std::span<const std::byte>>
+    ReadAll() {
+        auto total = remaining_;
+        buf_.resize(total);
+        for (uint32_t off = 0; off < total;) {
+            auto n = std::min(chunk_size_, total - off);
+            auto got = Read(std::span(buf_).subspan(off, n));
+            if (got != n) {
+                return std::nullopt;
+            }
+            off += n;
+        }
+        return std::span<const std::byte>(buf_);
+    }
+
+  private:
+    const SI& si_;
+    uint32_t remaining_;
+    std::vector<std::byte>& buf_;
+    const uint32_t chunk_size_;
+};
+
+/// Writes one cosave record. The record is opened on construction and is finished when the next
+/// record is opened or the save callback returns.
+template <SerializationApi SI>
+class RecordWriter final {
+  public:
+    RecordWriter(const RecordWriter&) = delete;
+    RecordWriter& operator=(const RecordWriter&) = delete;
+    RecordWriter(RecordWriter&&) = delete;
+    RecordWriter& operator=(RecordWriter&&) = delete;
+
+    RecordWriter(const SI& si, uint32_t type, uint32_t version)
+        : si_(si),
+          ok_(si.OpenRecord(type, version)) {}
+
+    /// Returns false if the record could not be opened or any write so far has failed.
+    bool
+    ok() const {
+        return ok_;
+    }
+
+    /// No-op once a previous operation has failed. Returns `ok()`.
+    bool
+    Write(std::span<const std::byte> data) {
+        if (ok_ && !data.empty()) {
+            ok_ = si_.WriteRecordData(data.data(), static_cast<uint32_t>(data.size()));
+        }
+        return ok_;
+    }
+
+  private:
+    const SI& si_;
+    bool ok_;
+};
+
+}  // namespace esas
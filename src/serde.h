@@ -91,7 +91,7 @@ tag_invoke(
     auto sz = std::min(v->size(), keyset.size());
     for (size_t i = 0; i < sz; i++) {
         std::string_view name = (*v)[i];
-        keyset[i] = KeycodeFromName(name);
+        keyset[i] = KeycodeFromNameLoose(name);
     }
     return KeysetNormalized(keyset);
 }
@@ -113,6 +113,9 @@ tag_invoke(
     if (auto field = internal::GetSerObjField<std::string>(jo, "log_level", ctx)) {
         settings.log_level = std::move(*field);
     }
+    if (auto field = internal::GetSerObjField<bool>(jo, "log_async", ctx)) {
+        settings.log_async = *field;
+    }
     if (auto field = internal::GetSerObjField<std::vector<Keyset>>(
             jo, "convert_spell_keysets", ctx
         )) {
@@ -123,15 +126,34 @@ tag_invoke(
         )) {
         settings.remove_shout_keysets = Keysets(std::move(*field));
     }
+    if (auto field = internal::GetSerObjField<std::vector<Keyset>>(
+            jo, "save_loadout_keysets", ctx
+        )) {
+        settings.save_loadout_keysets = Keysets(std::move(*field));
+    }
+    if (auto field = internal::GetSerObjField<std::vector<Keyset>>(
+            jo, "apply_loadout_keysets", ctx
+        )) {
+        settings.apply_loadout_keysets = Keysets(std::move(*field));
+    }
     if (auto field = internal::GetSerObjField<bool>(jo, "allow_2h_spells", ctx)) {
         settings.allow_2h_spells = *field;
     }
+    if (auto field = internal::GetSerObjField<bool>(jo, "console_shout_commands", ctx)) {
+        settings.console_shout_commands = *field;
+    }
     if (auto field = internal::GetSerObjField<float>(jo, "magicka_scale_faf", ctx)) {
         settings.magicka_scale_faf = *field;
     }
     if (auto field = internal::GetSerObjField<float>(jo, "magicka_scale_conc", ctx)) {
         settings.magicka_scale_conc = *field;
     }
+    if (auto field = internal::GetSerObjField<float>(jo, "metrics_interval_secs", ctx)) {
+        settings.metrics_interval_secs = *field;
+    }
+    if (auto field = internal::GetSerObjField<float>(jo, "settings_reload_secs", ctx)) {
+        settings.settings_reload_secs = *field;
+    }
 
     return settings;
 }
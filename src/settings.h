@@ -6,6 +6,9 @@ namespace esas {
 
 struct Settings final {
     std::string log_level = "info";
+    /// If true, log messages are queued and written to file from a background thread, so logging
+    /// never blocks the game thread. If the queue is full, the oldest queued messages are dropped.
+    bool log_async = false;
     Keysets convert_spell_keysets = Keysets({
         {KeycodeFromName("LShift"), KeycodeFromName("=")},
         {KeycodeFromName("RShift"), KeycodeFromName("=")},
@@ -14,9 +17,22 @@ struct Settings final {
         {KeycodeFromName("LShift"), KeycodeFromName("-")},
         {KeycodeFromName("RShift"), KeycodeFromName("-")},
     });
+    /// Saves the current character's assignments as a loadout, named after the character.
+    Keysets save_loadout_keysets;
+    /// Replaces the current character's assignments with the loadout named after the character.
+    Keysets apply_loadout_keysets;
     bool allow_2h_spells = false;
+    /// Teach words and remove shouts through console commands rather than direct engine calls.
+    bool console_shout_commands = false;
     float magicka_scale_faf = 1.f;
     float magicka_scale_conc = 1.f;
+    /// If positive, collect handler latencies and event counts, and log them at this interval (at
+    /// least 1 second) and on every save. Otherwise metrics are off.
+    float metrics_interval_secs = 0.f;
+    /// If positive, check the settings file for changes at this interval (at least 1 second) and
+    /// apply them without restarting the game. `log_async`, `metrics_interval_secs` and
+    /// `settings_reload_secs` itself only take effect on restart.
+    float settings_reload_secs = 0.f;
 };
 
 }  // namespace esas
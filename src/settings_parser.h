@@ -0,0 +1,288 @@
+// Streaming settings parser.
+#pragma once
+
+#include "keys.h"
+#include "settings.h"
+
+namespace esas {
+namespace internal {
+
+/// Where a settings JSON field is stored.
+using SettingsTarget = std::variant<
+    std::string Settings::*,
+    bool Settings::*,
+    float Settings::*,
+    Keysets Settings::*>;
+
+inline constexpr auto kSettingsFields =
+    std::array<std::pair<std::string_view, SettingsTarget>, 12>{{
+        {"log_level", &Settings::log_level},
+        {"log_async", &Settings::log_async},
+        {"convert_spell_keysets", &Settings::convert_spell_keysets},
+        {"remove_shout_keysets", &Settings::remove_shout_keysets},
+        {"save_loadout_keysets", &Settings::save_loadout_keysets},
+        {"apply_loadout_keysets", &Settings::apply_loadout_keysets},
+        {"allow_2h_spells", &Settings::allow_2h_spells},
+        {"console_shout_commands", &Settings::console_shout_commands},
+        {"magicka_scale_faf", &Settings::magicka_scale_faf},
+        {"magicka_scale_conc", &Settings::magicka_scale_conc},
+        {"metrics_interval_secs", &Settings::metrics_interval_secs},
+        {"settings_reload_secs", &Settings::settings_reload_secs},
+    }};
+
+/// Returns null if `key` is not a settings field.
+constexpr const SettingsTarget*
+FindSettingsTarget(std::string_view key) {
+    for (const auto& [name, target] : kSettingsFields) {
+        if (name == key) {
+            return &target;
+        }
+    }
+    return nullptr;
+}
+
+/// `boost::json::basic_parser` handler that fills in `Settings` as the document streams by,
+/// without building a `boost::json::value`. Accepts and rejects exactly what the
+/// `Deserialize<Settings>()` path does:
+/// - A document that isn't an object yields default settings.
+/// - Unknown fields, and fields holding the wrong JSON type, are ignored.
+/// - A keyset that isn't an array of strings is treated as empty. Only its first 4 key names
+///   count.
+///
+/// Depths: the root object is at 1, a keysets field's array at 2, each keyset at 3.
+class SettingsSaxHandler final {
+  public:
+    static constexpr size_t max_object_size = std::numeric_limits<size_t>::max();
+    static constexpr size_t max_array_size = std::numeric_limits<size_t>::max();
+    static constexpr size_t max_key_size = std::numeric_limits<size_t>::max();
+    static constexpr size_t max_string_size = std::numeric_limits<size_t>::max();
+
+    using ErrorCode = boost::json::error_code;
+    using StringView = boost::json::string_view;
+
+    Settings settings;
+
+    bool
+    on_document_begin(ErrorCode&) {
+        return true;
+    }
+
+    bool
+    on_document_end(ErrorCode&) {
+        return true;
+    }
+
+    bool
+    on_object_begin(ErrorCode&) {
+        BeginContainer(/*is_array=*/false);
+        return true;
+    }
+
+    bool
+    on_object_end(size_t, ErrorCode&) {
+        EndContainer();
+        return true;
+    }
+
+    bool
+    on_array_begin(ErrorCode&) {
+        BeginContainer(/*is_array=*/true);
+        return true;
+    }
+
+    bool
+    on_array_end(size_t, ErrorCode&) {
+        EndContainer();
+        return true;
+    }
+
+    bool
+    on_key_part(StringView s, size_t, ErrorCode&) {
+        part_buf_.append(s.data(), s.size());
+        return true;
+    }
+
+    bool
+    on_key(StringView s, size_t, ErrorCode&) {
+        if (depth_ == 1) {
+            target_ = FindSettingsTarget(Assemble(s));
+        }
+        part_buf_.clear();
+        return true;
+    }
+
+    bool
+    on_string_part(StringView s, size_t, ErrorCode&) {
+        part_buf_.append(s.data(), s.size());
+        return true;
+    }
+
+    bool
+    on_string(StringView s, size_t, ErrorCode&) {
+        auto str = Assemble(s);
+        if (depth_ == 1) {
+            Assign<std::string>(std::string(str));
+        } else if (depth_ == 3 && in_keyset_) {
+            if (keyset_names_ < keyset_.size()) {
+                keyset_[keyset_names_] = KeycodeFromNameLoose(str);
+            }
+            keyset_names_++;
+        }
+        part_buf_.clear();
+        return true;
+    }
+
+    bool
+    on_number_part(StringView, ErrorCode&) {
+        return true;
+    }
+
+    bool
+    on_int64(int64_t i, StringView, ErrorCode&) {
+        OnScalar(static_cast<float>(i));
+        return true;
+    }
+
+    bool
+    on_uint64(uint64_t u, StringView, ErrorCode&) {
+        OnScalar(static_cast<float>(u));
+        return true;
+    }
+
+    bool
+    on_double(double d, StringView, ErrorCode&) {
+        OnScalar(static_cast<float>(d));
+        return true;
+    }
+
+    bool
+    on_bool(bool b, ErrorCode&) {
+        OnScalar(b);
+        return true;
+    }
+
+    bool
+    on_null(ErrorCode&) {
+        OnScalar(std::monostate());
+        return true;
+    }
+
+    bool
+    on_comment_part(StringView, ErrorCode&) {
+        return true;
+    }
+
+    bool
+    on_comment(StringView, ErrorCode&) {
+        return true;
+    }
+
+  private:
+    /// Returns the full string or key, whose earlier parts (if any) are in `part_buf_`.
+    std::string_view
+    Assemble(StringView last) {
+        if (part_buf_.empty()) {
+            return {last.data(), last.size()};
+        }
+        part_buf_.append(last.data(), last.size());
+        return part_buf_;
+    }
+
+    /// Writes `val` to the current field if the field has type `T`.
+    template <typename T>
+    void
+    Assign(T&& val) {
+        if (!target_ || !root_is_object_) {
+            return;
+        }
+        if (const auto* member = std::get_if<std::remove_cvref_t<T> Settings::*>(target_)) {
+            settings.*(*member) = std::forward<T>(val);
+        }
+    }
+
+    /// A non-string, non-container value.
+    template <typename T>
+    void
+    OnScalar(T val) {
+        if (depth_ == 1) {
+            if constexpr (!std::is_same_v<T, std::monostate>) {
+                Assign(val);
+            }
+        } else if (depth_ == 3 && in_keyset_) {
+            keyset_valid_ = false;
+        }
+    }
+
+    void
+    BeginContainer(bool is_array) {
+        depth_++;
+        if (depth_ == 1) {
+            root_is_object_ = !is_array;
+        } else if (depth_ == 2 && is_array && root_is_object_ && target_
+                   && std::holds_alternative<Keysets Settings::*>(*target_)) {
+            collecting_ = true;
+            keysets_buf_.clear();
+        } else if (depth_ == 3 && collecting_ && is_array) {
+            in_keyset_ = true;
+            keyset_valid_ = true;
+            keyset_names_ = 0;
+            keyset_ = KeysetNormalized({});
+        } else if (depth_ == 4 && in_keyset_) {
+            keyset_valid_ = false;
+        }
+    }
+
+    void
+    EndContainer() {
+        if (depth_ == 3 && in_keyset_) {
+            if (keyset_valid_) {
+                keysets_buf_.push_back(keyset_);
+            }
+            in_keyset_ = false;
+        } else if (depth_ == 2 && collecting_) {
+            settings.*std::get<Keysets Settings::*>(*target_) = Keysets(std::move(keysets_buf_));
+            keysets_buf_ = {};
+            collecting_ = false;
+        }
+        depth_--;
+    }
+
+    size_t depth_ = 0;
+    bool root_is_object_ = false;
+    /// The root object's field that the current value belongs to. Null if unknown.
+    const SettingsTarget* target_ = nullptr;
+    /// Holds the parts of a string or key that arrived in pieces.
+    std::string part_buf_;
+
+    /// Whether we're inside a keysets field's array.
+    bool collecting_ = false;
+    std::vector<Keyset> keysets_buf_;
+    /// Whether we're inside one of that array's keysets.
+    bool in_keyset_ = false;
+    bool keyset_valid_ = false;
+    size_t keyset_names_ = 0;
+    Keyset keyset_{};
+};
+
+}  // namespace internal
+
+/// Same result as `Deserialize<Settings>(s)`, but parses in a single streaming pass with no
+/// intermediate JSON DOM, and decodes key names straight into keysets. Returns nullopt if `s` is
+/// not valid JSON. Input is allowed to contain comments and trailing commas.
+inline std::optional<Settings>
+ParseSettings(std::string_view s) {
+    constexpr auto opts = boost::json::parse_options{
+        .allow_comments = true,
+        .allow_trailing_commas = true,
+    };
+
+    auto parser = boost::json::basic_parser<internal::SettingsSaxHandler>(opts);
+    auto ec = boost::json::error_code();
+    auto n = parser.write_some(false, s.data(), s.size(), ec);
+    if (ec || n < s.size() || !parser.done()) {
+        return std::nullopt;
+    }
+    return std::move(parser.handler().settings);
+}
+
+}  // namespace esas
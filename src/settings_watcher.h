@@ -0,0 +1,120 @@
+// Settings hot-reload.
+#pragma once
+
+#include "fs.h"
+#include "periodic_thread.h"
+#include "rcu.h"
+#include "settings.h"
+#include "settings_parser.h"
+
+namespace esas {
+
+/// Reloads settings whenever the settings file changes, without involving the game thread.
+///
+/// A background thread polls the file's modification time and size. When either changes, the file
+/// is parsed on that thread and the result is published to an `Rcu<Settings>` as a single
+/// immutable snapshot, so readers see either the old settings or the new ones in full, never a mix.
+/// Files that can't be read or parsed (e.g. while an editor is midway through saving) are skipped
+/// and the current settings stay in effect. They're retried on every poll, since an editor's final
+/// write can leave the modification time and size unchanged.
+class SettingsWatcher final {
+  public:
+    /// Called on the watcher's thread after new settings are published.
+    using OnReload = std::function<void(const Settings&)>;
+
+    SettingsWatcher(const SettingsWatcher&) = delete;
+    SettingsWatcher& operator=(const SettingsWatcher&) = delete;
+    SettingsWatcher(SettingsWatcher&&) = delete;
+    SettingsWatcher& operator=(SettingsWatcher&&) = delete;
+
+    /// Does not start a thread. The file's current contents are assumed to already be reflected in
+    /// `settings`.
+    SettingsWatcher(std::string path, Rcu<Settings>& settings, OnReload on_reload = nullptr)
+        : path_(std::move(path)),
+          settings_(settings),
+          on_reload_(std::move(on_reload)),
+          stamp_(Stamp(path_)) {}
+
+    /// Calls `Poll()` every `interval` from a background thread, until destroyed.
+    SettingsWatcher(
+        std::string path,
+        Rcu<Settings>& settings,
+        std::chrono::milliseconds interval,
+        OnReload on_reload = nullptr
+    )
+        : SettingsWatcher(std::move(path), settings, std::move(on_reload)) {
+        thread_.emplace(interval, [this]() { Poll(); });
+    }
+
+    /// Checks the file once, reloading if it changed since settings were last loaded from it.
+    /// Returns true if new settings were published. Not safe to call concurrently with itself.
+    bool
+    Poll() {
+        auto stamp = Stamp(path_);
+        if (!stamp || stamp == stamp_) {
+            return false;
+        }
+
+        auto settings =
+            fs::FileContents::Read(path_).and_then([](const fs::FileContents& contents) {
+                return ParseSettings(contents.view());
+            });
+        if (!settings) {
+            if (stamp != failed_stamp_) {
+                spdlog::warn("'{}' cannot be parsed, keeping current settings", path_);
+                failed_stamp_ = stamp;
+            }
+            return false;
+        }
+        stamp_ = stamp;
+        auto next = std::make_unique<const Settings>(std::move(*settings));
+        const auto& published = *next;
+        settings_.Publish(std::move(next));
+        if (on_reload_) {
+            // `published` stays alive: only this thread publishes, and it doesn't do so again
+            // until this call returns.
+            on_reload_(published);
+        }
+        return true;
+    }
+
+  private:
+    struct FileStamp {
+        std::filesystem::file_time_type mtime;
+        uintmax_t size = 0;
+
+        bool operator==(const FileStamp&) const = default;
+    };
+
+    /// Returns nullopt if the file doesn't exist or can't be inspected.
+    static std::optional<FileStamp>
+    Stamp(std::string_view path) {
+        auto fp = fs::PathFromStr(path);
+        if (!fp) {
+            return std::nullopt;
+        }
+        auto ec = std::error_code();
+        auto mtime = std::filesystem::last_write_time(*fp, ec);
+        if (ec) {
+            return std::nullopt;
+        }
+        auto size = std::filesystem::file_size(*fp, ec);
+        if (ec) {
+            return std::nullopt;
+        }
+        return FileStamp{.mtime = mtime, .size = size};
+    }
+
+    std::string path_;
+    Rcu<Settings>& settings_;
+    OnReload on_reload_;
+    /// Stamp of the file when settings were last loaded from it.
+    std::optional<FileStamp> stamp_;
+    /// Stamp of the file when it last failed to load, so that each failure is only warned about
+    /// once.
+    std::optional<FileStamp> failed_stamp_;
+    /// Declared last so that it's joined before anything it uses is destroyed.
+    std::optional<PeriodicThread> thread_;
+};
+
+}  // namespace esas
@@ -0,0 +1,49 @@
+// Snapshot of an actor's shouts.
+#pragma once
+
+#include "adapters.h"
+
+namespace esas {
+
+/// Form IDs of an actor's shouts, captured in one pass over the actor's shout list. Answers
+/// `HasShout()` by binary search, where the actor itself would scan its whole list every time.
+///
+/// Invariant: `ids_` is sorted and has no duplicates.
+class ShoutSet final {
+  public:
+    ShoutSet() = default;
+
+    /// `shouts` is a range of shout pointers, e.g. `tes_util::GetShouts()`. Nulls are skipped.
+    template <std::ranges::input_range R>
+    explicit ShoutSet(const R& shouts) {
+        for (const auto* shout : shouts) {
+            if (shout) {
+                ids_.push_back(shout->GetFormID());
+            }
+        }
+        std::ranges::sort(ids_);
+        auto dupes = std::ranges::unique(ids_);
+        ids_.erase(dupes.begin(), dupes.end());
+    }
+
+    size_t
+    size() const {
+        return ids_.size();
+    }
+
+    bool
+    Contains(uint32_t form_id) const {
+        return std::ranges::binary_search(ids_, form_id);
+    }
+
+    template <FormLike Shout>
+    bool
+    HasShout(const Shout* shout) const {
+        return shout && Contains(shout->GetFormID());
+    }
+
+  private:
+    std::vector<uint32_t> ids_;
+};
+
+}  // namespace esas
@@ -0,0 +1,172 @@
+// Spell shout slot bookkeeping, independent of the game's form types.
+#pragma once
+
+#include "adapters.h"
+#include "form_index.h"
+#include "slot_allocator.h"
+
+namespace esas {
+
+/// A growable set of shout slots, each holding at most one spell, along with a `Profile` of data
+/// derived from that spell (e.g. a `CastProfile`).
+///
+/// Invariants:
+/// - `shouts_.size() == spells_.size() == profiles_.size()`
+/// - Every element of `shouts_` is non-null.
+/// - `shout_index_` maps the form ID of `shouts_[i]` to `i`.
+/// - `spell_index_` maps the form ID of every non-null element of `spells_` to the lowest `i` at
+///   which it occurs.
+/// - `alloc_.size() == shouts_.size()`, and `alloc_.assigned(i)` iff `spells_[i]` is non-null.
+/// - `profiles_[i]` is default-constructed if `spells_[i]` is null.
+template <FormLike Shout, FormLike Spell, std::regular Profile = std::monostate>
+class ShoutSlots final {
+  public:
+    ShoutSlots() = default;
+
+    /// All slots start out empty. `shouts` must not contain null.
+    explicit ShoutSlots(std::vector<Shout*> shouts)
+        : shouts_(std::move(shouts)),
+          spells_(shouts_.size(), nullptr),
+          profiles_(shouts_.size()),
+          shout_index_(shouts_.size()),
+          spell_index_(shouts_.size()),
+          alloc_(shouts_.size()) {
+        for (size_t i = 0; i < shouts_.size(); i++) {
+            shout_index_.Insert(shouts_[i]->GetFormID(), static_cast<uint32_t>(i));
+        }
+    }
+
+    size_t
+    size() const {
+        return shouts_.size();
+    }
+
+    const std::vector<Shout*>&
+    shouts() const {
+        return shouts_;
+    }
+
+    const std::vector<Spell*>&
+    spells() const {
+        return spells_;
+    }
+
+    /// Profile of the spell in slot `i`, which must be `< size()`.
+    const Profile&
+    profile(size_t i) const {
+        return profiles_[i];
+    }
+
+    /// Returns a value `>= size()` if `shout` is not in a slot.
+    size_t
+    IndexOf(const Shout& shout) const {
+        auto i = shout_index_.Find(shout.GetFormID());
+        return i < size() && shouts_[i] == &shout ? i : size();
+    }
+
+    /// Returns a value `>= size()` if `spell` is not in a slot.
+    size_t
+    IndexOf(const Spell& spell) const {
+        auto i = spell_index_.Find(spell.GetFormID());
+        return i < size() && spells_[i] == &spell ? i : size();
+    }
+
+    /// Appends an empty slot. `shout` must not be null or already in a slot.
+    void
+    Add(Shout* shout) {
+        auto i = size();
+        shouts_.push_back(shout);
+        spells_.push_back(nullptr);
+        profiles_.emplace_back();
+        shout_index_.Insert(shout->GetFormID(), static_cast<uint32_t>(i));
+        alloc_.Add();
+    }
+
+    /// Puts `spell` (or nothing, if null) in slot `i`, which must be `< size()`, and replaces the
+    /// slot's profile with `profile`. Ignores `profile` if `spell` is null.
+    void
+    Set(size_t i, Spell* spell, Profile profile = Profile()) {
+        profiles_[i] = spell ? std::move(profile) : Profile();
+        if (spells_[i] == spell) {
+            return;
+        }
+        UnindexSpell(i);
+        spells_[i] = spell;
+        if (spell) {
+            IndexSpell(i);
+        }
+        alloc_.SetAssigned(i, spell != nullptr);
+    }
+
+    /// Whether the player has the shout in slot `i` (which must be `< size()`), per the ownership
+    /// records.
+    bool
+    owned(size_t i) const {
+        return alloc_.owned(i);
+    }
+
+    /// Records whether the player has the shout in slot `i`, which must be `< size()`.
+    void
+    SetOwned(size_t i, bool owned) {
+        alloc_.SetOwned(i, owned);
+    }
+
+    /// Replaces all ownership records with `owned_shouts`, the shouts that the player has. Shouts
+    /// that aren't in a slot are ignored.
+    template <std::ranges::input_range R>
+    void
+    RefreshOwned(const R& owned_shouts) {
+        alloc_.ClearOwned();
+        for (const auto* shout : owned_shouts) {
+            auto i = shout ? IndexOf(*shout) : size();
+            if (i < size()) {
+                alloc_.SetOwned(i, true);
+            }
+        }
+    }
+
+    /// Returns the first slot whose shout the player doesn't have (per the ownership records), or
+    /// else the first slot without a spell, or a value `>= size()` if there is none. A slot whose
+    /// shout the player doesn't have counts as unassigned, even if it holds a spell.
+    size_t
+    NextUnassigned() const {
+        return alloc_.Next();
+    }
+
+  private:
+    /// Indexes `spells_[i]` (which must be non-null) unless it already occurs at a lower index.
+    void
+    IndexSpell(size_t i) {
+        auto id = spells_[i]->GetFormID();
+        if (spell_index_.Find(id) > i) {
+            spell_index_.Insert(id, static_cast<uint32_t>(i));
+        }
+    }
+
+    /// Removes `spells_[i]` (no-op if null) from the index. If the same spell is also assigned to a
+    /// later slot, reindexes it to that slot. Spells assigned to multiple slots only arise from
+    /// malformed cosaves, so the fallback scan is effectively never taken.
+    void
+    UnindexSpell(size_t i) {
+        auto* spell = spells_[i];
+        if (!spell || spell_index_.Find(spell->GetFormID()) != i) {
+            return;
+        }
+        spell_index_.Erase(spell->GetFormID());
+        for (auto j = i + 1; j < size(); j++) {
+            if (spells_[j] == spell) {
+                spell_index_.Insert(spell->GetFormID(), static_cast<uint32_t>(j));
+                break;
+            }
+        }
+    }
+
+    std::vector<Shout*> shouts_;
+    std::vector<Spell*> spells_;
+    std::vector<Profile> profiles_;
+    FormIndex shout_index_;
+    FormIndex spell_index_;
+    SlotAllocator alloc_;
+};
+
+}  // namespace esas
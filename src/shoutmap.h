@@ -1,114 +1,240 @@
 #pragma once
 
+#include "console_batch.h"
+#include "cosave.h"
+#include "forms.h"
+#include "loadout.h"
+#include "logging.h"
 #include "serde.h"
+#include "shout_set.h"
+#include "shout_slots.h"
 #include "tes_util.h"
 
 namespace esas {
 namespace internal {
 
-inline constexpr std::string_view kModname = ESAS_NAME ".esp";
+/// Upper bound on the number of dynamic shouts, as a guard against runaway growth.
+inline constexpr size_t kMaxDynamicShouts = 512;
 
-/// The word of power that players must know in order to cast this mod's shouts.
-inline RE::TESWordOfPower*
-Word() {
-    return tes_util::GetForm<RE::TESWordOfPower>(kModname, 0x801);
+/// In cosaves, dynamic shouts are identified by `kDynamicShoutTag + k`, where `k` is the dynamic
+/// shout's index, in place of a local form ID. Plugin local IDs in general go up to 0xffffff, so
+/// this only works because the shouts in this mod's own plugin all have local IDs far below the
+/// tag, and `k < kMaxDynamicShouts` keeps tagged IDs within 0xffffff.
+inline constexpr uint32_t kDynamicShoutTag = 0xff0000;
+static_assert(kDynamicShoutTag + kMaxDynamicShouts <= 0x1000000);
+
+/// Returns a new shout copied from `tmpl`, or null on failure. Dynamic forms aren't saved by the
+/// game, so these are recreated every session.
+inline RE::TESShout*
+CreateShout(const RE::TESShout& tmpl) {
+    auto* fac = RE::IFormFactory::GetConcreteFormFactoryByType<RE::TESShout>();
+    auto* shout = fac ? fac->Create() : nullptr;
+    if (!shout) {
+        return nullptr;
+    }
+    if (shout->GetFormID() == 0) {
+        SKSE::log::error("dynamic shout was created without a form ID");
+        return nullptr;
+    }
+    shout->SetFullName(tmpl.GetName());
+    std::ranges::copy(tmpl.variations, shout->variations);
+    auto* shout_disp = shout->As<RE::BGSMenuDisplayObject>();
+    const auto* tmpl_disp = tmpl.As<RE::BGSMenuDisplayObject>();
+    if (shout_disp && tmpl_disp) {
+        shout_disp->CopyComponent(const_cast<RE::BGSMenuDisplayObject*>(tmpl_disp));
+    }
+    return shout;
 }
 
-/// Word of power that players should never know. Used to prevent casting the level 2/3 variations
-/// of concentration shouts.
-///
-/// Concentration shouts are NOT triggered by the release of the shout button; rather, player keeps
-/// the shout button held, and waits until the shout startup animation finishes. Knowing words 2 or
-/// 3 results in a longer startup.
-inline RE::TESWordOfPower*
-UnlearnedWord() {
-    return tes_util::GetForm<RE::TESWordOfPower>(kModname, 0x802);
+/// Dynamic shouts created by `DynamicShout()` this session, in index order.
+inline std::vector<RE::TESShout*>&
+CreatedDynamicShouts() {
+    static auto created = std::vector<RE::TESShout*>();
+    return created;
 }
 
-/// Placeholder shout that does not participate in spell assignments.
+/// Returns the `k`-th dynamic shout, creating it (and any before it) from `tmpl` if needed.
+/// Returns null on failure or if `k >= kMaxDynamicShouts`.
 ///
-/// On learning a word of power, the corresponding shout gets auto-added to the player's inventory.
-/// If multiple shouts share the same word, the shout with the lowest form ID is the one that gets
-/// added. This default shout functions as that "shout with lowest ID", and we unconditionally
-/// remove it from the player's inventory after teachword finishes. If this shout did not exist,
-/// teachword would add a real shout, and we would have to check whether we should remove that shout
-/// (was the shout meant to be assigned, or was it added purely due to teachword?)
+/// Dynamic shouts are kept for the rest of the session, so that reloading and reassigning reuses
+/// them instead of creating more.
 inline RE::TESShout*
-DefaultShout() {
-    return tes_util::GetForm<RE::TESShout>(kModname, 0x8ff);
-}
-
-/// The real shouts, i.e. the ones that get spell assignments.
-inline std::vector<RE::TESShout*>
-Shouts() {
-    constexpr RE::FormID first = 0x900;
-    constexpr RE::FormID count = 30;
-    auto v = std::vector<RE::TESShout*>();
-    for (RE::FormID i = 0; i < count; i++) {
-        auto* shout = tes_util::GetForm<RE::TESShout>(kModname, first + i);
-        if (shout) {
-            v.push_back(shout);
+DynamicShout(size_t k, const RE::TESShout& tmpl) {
+    auto& created = CreatedDynamicShouts();
+    if (k >= kMaxDynamicShouts) {
+        return nullptr;
+    }
+    while (created.size() <= k) {
+        auto* shout = CreateShout(tmpl);
+        if (!shout) {
+            return nullptr;
         }
+        ESAS_LOG_DEBUG("created dynamic shout {}", *shout);
+        created.push_back(shout);
     }
-    return v;
+    return created[k];
 }
 
 }  // namespace internal
 
-/// Shouts and their spell assignments.
-///
-/// Invariants:
-/// - `size() == shouts_.size() == spells_.size()`
-/// - Every element of `shouts_` is non-null.
+/// Teaches words of power and removes shouts from the player, either through direct engine calls
+/// or, if `use_console` is set, through console commands that are batched until `Flush()`.
+class ShoutCommands final {
+  public:
+    explicit ShoutCommands(bool use_console) : use_console_(use_console) {}
+
+    ShoutCommands(const ShoutCommands&) = delete;
+    ShoutCommands& operator=(const ShoutCommands&) = delete;
+    ShoutCommands(ShoutCommands&&) = delete;
+    ShoutCommands& operator=(ShoutCommands&&) = delete;
+
+    /// Only call while no commands are pending, i.e. before issuing any or right after `Flush()`.
+    void
+    SetUseConsole(bool use_console) {
+        use_console_ = use_console;
+    }
+
+    void
+    TeachWord(RE::TESWordOfPower& word) {
+        if (use_console_) {
+            console_.TeachWord(word.GetFormID());
+        } else {
+            tes_util::TeachWord(word);
+        }
+    }
+
+    /// `teachword` also adds the lowest-ID shout that uses the taught word. Only the console
+    /// version needs that undone.
+    void
+    RemoveTeachWordShout(RE::Actor& player, RE::TESShout& shout) {
+        if (use_console_) {
+            RemoveShout(player, shout);
+        }
+    }
+
+    void
+    RemoveShout(RE::Actor& player, RE::TESShout& shout) {
+        if (use_console_) {
+            console_.RemoveShout(shout.GetFormID());
+        } else if (!tes_util::RemoveShout(player, shout)) {
+            ESAS_LOG_TRACE("{} was already removed", shout);
+        }
+    }
+
+    /// Call after giving `shout` back to the player, so that a pending removal doesn't undo that.
+    void
+    CancelRemoveShout(RE::TESShout& shout) {
+        console_.CancelRemoveShout(shout.GetFormID());
+    }
+
+    /// Runs batched console commands. No-op when not using the console.
+    void
+    Flush() {
+        if (console_.empty()) {
+            return;
+        }
+        if (auto failures = console_.Flush(console_script_)) {
+            SKSE::log::error("cannot run {} console command(s)", failures);
+        }
+    }
+
+  private:
+    bool use_console_;
+    ConsoleBatch console_;
+    tes_util::ConsoleScript console_script_;
+};
+
+/// Shouts and their spell assignments. Slot bookkeeping is delegated to `ShoutSlots`; this class
+/// adds everything that touches the game (form edits, console commands, the player's inventory).
 class Shoutmap final {
   public:
     /// Returns an empty Shoutmap with no shouts and no spells.
     Shoutmap() = default;
 
-    /// Returns a Shoutmap containing all spell shouts unassigned.
+    /// Returns a Shoutmap containing all of the plugin's spell shouts unassigned, and no dynamic
+    /// shouts.
     static Shoutmap
     New() {
         auto map = Shoutmap();
-        map.shouts_ = internal::Shouts();
-        map.spells_ = std::vector<RE::SpellItem*>(map.shouts_.size(), nullptr);
+        map.slots_ = Slots(ResolvedForms::Get().shouts);
+        map.plugin_shouts_ = map.slots_.size();
         return map;
     }
 
     size_t
     size() const {
-        return shouts_.size();
+        return slots_.size();
+    }
+
+    /// Slots `[plugin_shouts(), size())` hold dynamic shouts.
+    size_t
+    plugin_shouts() const {
+        return plugin_shouts_;
+    }
+
+    /// Returns the `k`-th dynamic shout, adding slots for it (and any dynamic shouts before it) as
+    /// needed. Returns null if the shout can't be created or `k >= internal::kMaxDynamicShouts`.
+    RE::TESShout*
+    DynamicShout(size_t k) {
+        if (plugin_shouts_ == 0 || k >= internal::kMaxDynamicShouts) {
+            return nullptr;
+        }
+        while (size() <= plugin_shouts_ + k) {
+            auto* shout = internal::DynamicShout(size() - plugin_shouts_, *shouts()[0]);
+            if (!shout) {
+                return nullptr;
+            }
+            slots_.Add(shout);
+        }
+        return shouts()[plugin_shouts_ + k];
     }
 
     const std::vector<RE::TESShout*>&
     shouts() const {
-        return shouts_;
+        return slots_.shouts();
     }
 
     const std::vector<RE::SpellItem*>&
     spells() const {
-        return spells_;
+        return slots_.spells();
     }
 
     bool
     Has(const RE::TESShout& shout) const {
-        return IndexOf(shout) < size();
+        return slots_.IndexOf(shout) < size();
     }
 
     bool
     Has(const RE::SpellItem& spell) const {
-        return IndexOf(spell) < size();
+        return slots_.IndexOf(spell) < size();
     }
 
     RE::SpellItem*
     operator[](const RE::TESShout& shout) const {
-        auto i = IndexOf(shout);
-        return i < size() ? spells_[i] : nullptr;
+        auto i = slots_.IndexOf(shout);
+        return i < size() ? spells()[i] : nullptr;
     }
 
     RE::TESShout*
     operator[](const RE::SpellItem& spell) const {
-        auto i = IndexOf(spell);
-        return i < size() ? shouts_[i] : nullptr;
+        auto i = slots_.IndexOf(spell);
+        return i < size() ? shouts()[i] : nullptr;
+    }
+
+    struct SpellAssignment {
+        /// Null if the shout is unknown or unassigned.
+        RE::SpellItem* spell = nullptr;
+        tes_util::SpellProfile profile;
+    };
+
+    /// Like `operator[]`, but also returns the profile computed when the spell was assigned.
+    SpellAssignment
+    Lookup(const RE::TESShout& shout) const {
+        auto i = slots_.IndexOf(shout);
+        if (i >= size()) {
+            return {};
+        }
+        return {.spell = spells()[i], .profile = slots_.profile(i)};
     }
 
     enum class AssignStatus {
@@ -120,9 +246,14 @@ class Shoutmap final {
     };
 
     /// Will never return `kUnknownShout`. `assigned_shout` will only be written if returned status
-    /// is `kOk`.
+    /// is `kOk`. The caller must flush `commands`.
     AssignStatus
-    Assign(RE::Actor& player, RE::SpellItem& spell, RE::TESShout*& assigned_shout) {
+    Assign(
+        RE::Actor& player,
+        RE::SpellItem& spell,
+        ShoutCommands& commands,
+        RE::TESShout*& assigned_shout
+    ) {
         auto* shout = (*this)[spell];
         if (shout && player.HasShout(shout)) {
             return AssignStatus::kAlreadyAssigned;
@@ -134,21 +265,10 @@ class Shoutmap final {
             }
         }
 
-        auto* word = internal::Word();
-        auto* default_shout = internal::DefaultShout();
-        if (!word || !default_shout) {
+        if (!TeachShoutWord(player, commands)) {
             return AssignStatus::kInternalError;
         }
-
-        // No way to check if a player knows a particular word, so we have to blindly assume these
-        // console commands work.
-        if (!tes_util::ConsoleRun("player.teachword {:08x}", word->GetFormID())
-            || !tes_util::ConsoleRun("player.removeshout {:08x}", default_shout->GetFormID())) {
-            return AssignStatus::kInternalError;
-        }
-
-        player.UnlockWord(word);
-        player.AddShout(shout);
+        GiveShout(player, *shout, commands);
         auto res = Assign(*shout, spell);
         if (res == AssignStatus::kOk) {
             assigned_shout = shout;
@@ -158,7 +278,7 @@ class Shoutmap final {
 
     AssignStatus
     Assign(RE::TESShout& shout, RE::SpellItem& spell) {
-        auto i = IndexOf(shout);
+        auto i = slots_.IndexOf(shout);
         if (i >= size()) {
             return AssignStatus::kUnknownShout;
         }
@@ -171,16 +291,18 @@ class Shoutmap final {
             shout_disp->CopyComponent(spell_disp);
         }
 
-        auto* word2and3 = spell.GetCastingType() == RE::MagicSystem::CastingType::kConcentration
-                              ? internal::UnlearnedWord()
-                              : internal::Word();
+        auto profile = tes_util::GetCastProfile(spell);
+        auto is_conc = profile.casting_type == CastingType::kConcentration;
+
+        const auto& forms = ResolvedForms::Get();
+        auto* word2and3 = is_conc ? forms.unlearned_word : forms.word;
         if (word2and3) {
             shout.variations[RE::TESShout::VariationID::kTwo].word = word2and3;
             shout.variations[RE::TESShout::VariationID::kThree].word = word2and3;
         }
 
         auto recovery = 0.f;
-        if (spell.GetCastingType() == RE::MagicSystem::CastingType::kConcentration) {
+        if (is_conc) {
             // Prevent the shout animation from looping.
             recovery = 5.f;
         }
@@ -188,70 +310,141 @@ class Shoutmap final {
             var.recoveryTime = recovery;
         }
 
-        spells_[i] = &spell;
+        slots_.Set(i, &spell, profile);
         return AssignStatus::kOk;
     }
 
     /// Will never return `kAlreadyAssigned` or `kOutOfSlots`. Will not reset `shout`'s form data.
+    /// The caller must flush `commands`.
     AssignStatus
-    Unassign(RE::Actor& player, RE::TESShout& shout) {
-        auto i = IndexOf(shout);
+    Unassign(RE::Actor& player, RE::TESShout& shout, ShoutCommands& commands) {
+        auto i = slots_.IndexOf(shout);
         if (i >= size()) {
             return AssignStatus::kUnknownShout;
         }
-        (void)player;
-        if (!tes_util::ConsoleRun("player.removeshout {:08x}", shout.GetFormID())) {
-            return AssignStatus::kInternalError;
-        }
-        spells_[i] = nullptr;
+        commands.RemoveShout(player, shout);
+        slots_.Set(i, nullptr);
+        slots_.SetOwned(i, false);
         return AssignStatus::kOk;
     }
 
+    struct LoadoutResult {
+        /// Spells newly assigned.
+        size_t assigned = 0;
+        /// Slots emptied without being given another spell.
+        size_t unassigned = 0;
+        /// Spells that could not be assigned.
+        size_t failed = 0;
+    };
+
+    /// Changes `player`'s assignments to exactly `spells`, in one pass. Spells already assigned
+    /// keep their shouts. Slots whose spells are dropped are given new spells before any shout is
+    /// added or removed, the word is taught at most once, and console commands are coalesced in
+    /// `commands`. The caller must flush `commands`.
+    LoadoutResult
+    ApplyLoadout(
+        RE::Actor& player, const std::vector<RE::SpellItem*>& spells, ShoutCommands& commands
+    ) {
+        SyncOwned(player);
+        auto diff = DiffLoadout(slots_, spells);
+        auto result = LoadoutResult();
+
+        for (auto [i, spell] : diff.reassign) {
+            auto status = Assign(*shouts()[i], *spell);
+            result.assigned += status == AssignStatus::kOk;
+            result.failed += status != AssignStatus::kOk;
+        }
+        for (auto i : diff.unassign) {
+            auto status = Unassign(player, *shouts()[i], commands);
+            result.unassigned += status == AssignStatus::kOk;
+        }
+        if (diff.assign.empty()) {
+            return result;
+        }
+
+        if (!TeachShoutWord(player, commands)) {
+            result.failed += diff.assign.size();
+            return result;
+        }
+        for (auto* spell : diff.assign) {
+            auto* shout = (*this)[*spell];
+            if (!shout) {
+                shout = NextUnassigned(player);
+            }
+            if (!shout) {
+                result.failed++;
+                continue;
+            }
+            GiveShout(player, *shout, commands);
+            auto status = Assign(*shout, *spell);
+            result.assigned += status == AssignStatus::kOk;
+            result.failed += status != AssignStatus::kOk;
+        }
+        return result;
+    }
+
   private:
-    size_t
-    IndexOf(const RE::TESShout& shout) const {
-        return std::find(shouts_.cbegin(), shouts_.cend(), &shout) - shouts_.cbegin();
+    using Slots = ShoutSlots<RE::TESShout, RE::SpellItem, tes_util::SpellProfile>;
+
+    /// Teaches `player` the word that all spell shouts use. Returns false if the word's forms are
+    /// missing.
+    bool
+    TeachShoutWord(RE::Actor& player, ShoutCommands& commands) {
+        const auto& forms = ResolvedForms::Get();
+        auto* word = forms.word;
+        auto* default_shout = forms.default_shout;
+        if (!word || !default_shout) {
+            return false;
+        }
+
+        // When going through the console, there's no way to tell whether the commands worked, so we
+        // have to blindly assume they do.
+        commands.TeachWord(*word);
+        commands.RemoveTeachWordShout(player, *default_shout);
+        player.UnlockWord(word);
+        return true;
     }
 
-    size_t
-    IndexOf(const RE::SpellItem& spell) const {
-        return std::find(spells_.cbegin(), spells_.cend(), &spell) - spells_.cbegin();
+    /// Gives `player` `shout`, which must be in a slot.
+    void
+    GiveShout(RE::Actor& player, RE::TESShout& shout, ShoutCommands& commands) {
+        player.AddShout(&shout);
+        commands.CancelRemoveShout(shout);
+        slots_.SetOwned(slots_.IndexOf(shout), true);
+    }
+
+    /// Resyncs slot ownership with `player`'s shouts. Runs every time, since nothing reliably
+    /// signals that the player's shouts changed by other means: the game can hand a reallocated
+    /// shout list the same address and size. It's a single pass over the player's shouts.
+    void
+    SyncOwned(const RE::Actor& player) {
+        slots_.RefreshOwned(tes_util::GetShouts(player));
     }
 
-    /// Shouts the player doesn't have are considered to be unassigned.
+    /// Grows the pool with a dynamic shout if every slot is taken.
     RE::TESShout*
-    NextUnassigned(RE::Actor& player) const {
-        // Prioritize shouts that the player doesn't have but are somehow mapped to a spell.
-        for (size_t i = 0; i < size(); i++) {
-            auto* shout = shouts_[i];
-            auto* spell = spells_[i];
-            if (spell && !player.HasShout(shout)) {
-                SKSE::log::trace("{} can be assigned to", *shout);
-                return shout;
-            }
-        }
-        for (size_t i = 0; i < size(); i++) {
-            auto* shout = shouts_[i];
-            auto* spell = spells_[i];
-            if (!spell) {
-                SKSE::log::trace("{} can be assigned to", *shout);
-                return shout;
+    NextUnassigned(const RE::Actor& player) {
+        SyncOwned(player);
+        auto i = slots_.NextUnassigned();
+        if (i >= size()) {
+            auto* shout = DynamicShout(size() - plugin_shouts_);
+            if (!shout) {
+                ESAS_LOG_TRACE("no remaining unassigned shouts");
+                return nullptr;
             }
+            i = size() - 1;
         }
-        SKSE::log::trace("no remaining unassigned shouts");
-        return nullptr;
+        ESAS_LOG_TRACE("{} can be assigned to", *shouts()[i]);
+        return shouts()[i];
     }
 
-    std::vector<RE::TESShout*> shouts_;
-    std::vector<RE::SpellItem*> spells_;
+    Slots slots_;
+    size_t plugin_shouts_ = 0;
 };
 
-/// Maps spell shout local IDs to spell absolute IDs.
-using ShoutmapIR = std::vector<std::pair<RE::FormID, RE::FormID>>;
-
-/// Returns all assignments for which the shout is in `player`'s inventory.
+/// Returns all assignments for which the shout is in `owned`, the player's shouts.
 inline ShoutmapIR
-ShoutmapToIR(const Shoutmap& map, const RE::Actor& player) {
+ShoutmapToIR(const Shoutmap& map, const ShoutSet& owned) {
     auto ir = ShoutmapIR();
 
     for (size_t i = 0; i < map.size(); i++) {
@@ -260,42 +453,56 @@ ShoutmapToIR(const Shoutmap& map, const RE::Actor& player) {
         if (!spell) {
             continue;
         }
-        if (!player.HasShout(shout)) {
-            SKSE::log::trace(
+        if (!owned.HasShout(shout)) {
+            ESAS_LOG_TRACE(
                 "discarding {}: assigned to {} but not in player inventory", *shout, *spell
             );
             continue;
         }
-        ir.emplace_back(shout->GetLocalFormID(), spell->GetFormID());
+        auto shout_id = shout->GetLocalFormID();
+        if (i >= map.plugin_shouts()) {
+            shout_id = internal::kDynamicShoutTag + static_cast<uint32_t>(i - map.plugin_shouts());
+        }
+        ir.emplace_back(shout_id, spell->GetFormID());
     }
 
     return ir;
 }
 
 /// Writes all valid assignment from `ir` into `map`, filtering only for assignments where the shout
-/// is in `player`'s inventory. Returns the number of shout-spell pairs written to `map`.
+/// is in `owned`, the player's shouts. Returns the number of shout-spell pairs written to `map`.
+///
+/// Dynamic shouts are recreated as needed. `PruneSavedDynamicShouts()` takes them out of the
+/// player's shouts on load, so they're given back to `player` instead of being filtered.
 inline size_t
-ShoutmapFillFromIR(Shoutmap& map, const ShoutmapIR& ir, const RE::Actor& player) {
+ShoutmapFillFromIR(
+    Shoutmap& map, const ShoutmapIR& ir, RE::Actor& player, const ShoutSet& owned
+) {
     size_t assignments = 0;
 
-    for (const auto& [shout_local_id, spell_id] : ir) {
-        auto* shout = tes_util::GetForm<RE::TESShout>(internal::kModname, shout_local_id);
+    for (const auto& [shout_id, spell_id] : ir) {
+        auto dynamic = shout_id >= internal::kDynamicShoutTag;
+        auto* shout = dynamic ? map.DynamicShout(shout_id - internal::kDynamicShoutTag)
+                              : tes_util::GetForm<RE::TESShout>(kModname, shout_id);
         if (!shout) {
             continue;
         }
         if (!map.Has(*shout)) {
-            SKSE::log::trace("{} was stored in shoutmap but is not a spell shout", *shout);
+            ESAS_LOG_TRACE("{} was stored in shoutmap but is not a spell shout", *shout);
             continue;
         }
         auto* spell = tes_util::GetForm<RE::SpellItem>(spell_id);
         if (!spell) {
             continue;
         }
-        if (!player.HasShout(shout)) {
-            SKSE::log::trace(
-                "discarding {}: assigned to {} but not in player inventory", *shout, *spell
-            );
-            continue;
+        if (!owned.HasShout(shout)) {
+            if (!dynamic) {
+                ESAS_LOG_TRACE(
+                    "discarding {}: assigned to {} but not in player inventory", *shout, *spell
+                );
+                continue;
+            }
+            player.AddShout(shout);
         }
 
         switch (auto status = map.Assign(*shout, *spell)) {
@@ -316,4 +523,64 @@ ShoutmapFillFromIR(Shoutmap& map, const ShoutmapIR& ir, const RE::Actor& player)
     return assignments;
 }
 
+/// Returns the spells assigned to shouts in `owned`, the player's shouts, in slot order. Spells are
+/// identified by plugin name and local form ID, so the loadout still applies after the load order
+/// changes. Dynamic spells are skipped, since their form IDs mean nothing outside this save.
+inline Loadout
+ShoutmapToLoadout(const Shoutmap& map, const ShoutSet& owned) {
+    auto loadout = Loadout();
+    for (size_t i = 0; i < map.size(); i++) {
+        auto* spell = map.spells()[i];
+        if (!spell || !owned.HasShout(map.shouts()[i])) {
+            continue;
+        }
+        auto [modname, id] = tes_util::GetNamedFormID(*spell);
+        if (modname.empty()) {
+            ESAS_LOG_TRACE("not saving {} to loadout: dynamic spell", *spell);
+            continue;
+        }
+        loadout.spells.push_back({.modname = std::string(modname), .id = id});
+    }
+    return loadout;
+}
+
+/// Looks up `loadout`'s spells in the current load order, in loadout order. Spells that no longer
+/// exist (e.g. because their plugin was removed) are skipped.
+inline std::vector<RE::SpellItem*>
+LoadoutSpells(const Loadout& loadout) {
+    auto spells = std::vector<RE::SpellItem*>();
+    spells.reserve(loadout.spells.size());
+    for (const auto& [modname, id] : loadout.spells) {
+        if (auto* spell = tes_util::GetForm<RE::SpellItem>(modname, id)) {
+            spells.push_back(spell);
+        }
+    }
+    return spells;
+}
+
+/// Whether any of this mod's dynamic shouts is in `owned`, the player's shouts.
+inline bool
+OwnsDynamicShouts(const ShoutSet& owned) {
+    return std::ranges::any_of(internal::CreatedDynamicShouts(), [&](const RE::TESShout* shout) {
+        return owned.HasShout(shout);
+    });
+}
+
+/// Removes this mod's dynamic shouts, and unresolved (null) entries, from `player`'s shouts. Call
+/// when a save loads, before `ShoutmapFillFromIR()`, which gives back the dynamic shouts recorded
+/// in the cosave.
+///
+/// Dynamic shouts aren't saved by the game, but the player's shout list is, along with the form IDs
+/// of any dynamic shouts in it. Those IDs belong to the session that made the save. Once loaded,
+/// one that matches a dynamic shout this mod created this session may stand for a different slot
+/// than it did when saved, so it can't be trusted. Dynamic shouts from other plugins are left
+/// alone.
+inline size_t
+PruneSavedDynamicShouts(RE::Actor& player) {
+    const auto& created = internal::CreatedDynamicShouts();
+    return tes_util::RemoveShoutsIf(player, [&](const RE::TESShout* shout) {
+        return !shout || std::ranges::find(created, shout) != created.end();
+    });
+}
+
 }  // namespace esas
@@ -0,0 +1,114 @@
+// Free shout slot tracking.
+#pragma once
+
+namespace esas {
+
+/// Tracks, for each shout slot, whether it holds a spell ("assigned") and whether the player has
+/// its shout ("owned"), and picks the slot for the next assignment.
+///
+/// A slot can take a new assignment if its shout is unowned or it is unassigned. Slots that are
+/// assigned but unowned (the player somehow lost the shout) are handed out first, then unassigned
+/// slots, each lowest index first. This is the same order as scanning every slot and asking the
+/// player about each shout, but needs only one bit scan per 64 slots.
+///
+/// Invariants:
+/// - `assigned_.size() == owned_.size() == ceil(size_ / 64)`
+/// - Bits at or beyond `size_` are clear in both bitmaps.
+class SlotAllocator final {
+  public:
+    SlotAllocator() = default;
+
+    /// Starts with `n` unassigned, unowned slots.
+    explicit SlotAllocator(size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            Add();
+        }
+    }
+
+    size_t
+    size() const {
+        return size_;
+    }
+
+    /// Appends an unassigned, unowned slot.
+    void
+    Add() {
+        if (size_ % 64 == 0) {
+            assigned_.push_back(0);
+            owned_.push_back(0);
+        }
+        size_++;
+    }
+
+    bool
+    assigned(size_t i) const {
+        return Get(assigned_, i);
+    }
+
+    bool
+    owned(size_t i) const {
+        return Get(owned_, i);
+    }
+
+    void
+    SetAssigned(size_t i, bool assigned) {
+        Set(assigned_, i, assigned);
+    }
+
+    void
+    SetOwned(size_t i, bool owned) {
+        Set(owned_, i, owned);
+    }
+
+    /// Marks every slot unowned. To resync with the player, call this and then `SetOwned()` for
+    /// each of the player's shouts.
+    void
+    ClearOwned() {
+        std::ranges::fill(owned_, 0);
+    }
+
+    /// Returns the slot for the next assignment, or a value `>= size()` if there is none.
+    size_t
+    Next() const {
+        for (size_t w = 0; w < assigned_.size(); w++) {
+            if (auto orphaned = assigned_[w] & ~owned_[w]) {
+                return w * 64 + static_cast<size_t>(std::countr_zero(orphaned));
+            }
+        }
+        for (size_t w = 0; w < assigned_.size(); w++) {
+            if (auto unassigned = ~assigned_[w] & ValidBits(w)) {
+                return w * 64 + static_cast<size_t>(std::countr_zero(unassigned));
+            }
+        }
+        return size_;
+    }
+
+  private:
+    static bool
+    Get(const std::vector<uint64_t>& bits, size_t i) {
+        return (bits[i / 64] >> (i % 64)) & 1;
+    }
+
+    static void
+    Set(std::vector<uint64_t>& bits, size_t i, bool val) {
+        auto bit = uint64_t(1) << (i % 64);
+        if (val) {
+            bits[i / 64] |= bit;
+        } else {
+            bits[i / 64] &= ~bit;
+        }
+    }
+
+    /// Mask of the bits in word `w` that correspond to slots.
+    uint64_t
+    ValidBits(size_t w) const {
+        auto n = size_ - w * 64;
+        return n >= 64 ? ~uint64_t(0) : (uint64_t(1) << n) - 1;
+    }
+
+    size_t size_ = 0;
+    std::vector<uint64_t> assigned_;
+    std::vector<uint64_t> owned_;
+};
+
+}  // namespace esas
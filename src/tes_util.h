@@ -1,6 +1,9 @@
 // Utilities on top of CommonLibSSE.
 #pragma once
 
+#include "cast_profile.h"
+#include "logging.h"
+
 /// This is only for fmtlib (used by logging). stdlib formatting requires separate formatter
 /// specializations.
 template <>
@@ -49,12 +52,31 @@ inline constexpr RE::FormID kEqupEitherHand = 0x13f44;
 inline constexpr RE::FormID kEqupBothHands = 0x13f45;
 inline constexpr RE::FormID kWeapDummy = 0x20163;
 
+using SpellProfile = CastProfile<RE::BGSSoundDescriptorForm>;
+
+static_assert(
+    std::to_underlying(CastingType::kFireAndForget)
+    == std::to_underlying(RE::MagicSystem::CastingType::kFireAndForget)
+);
+static_assert(
+    std::to_underlying(CastingType::kConcentration)
+    == std::to_underlying(RE::MagicSystem::CastingType::kConcentration)
+);
+static_assert(
+    std::to_underlying(CastSoundID::kRelease)
+    == std::to_underlying(RE::MagicSystem::SoundID::kRelease)
+);
+static_assert(
+    std::to_underlying(CastSoundID::kCastLoop)
+    == std::to_underlying(RE::MagicSystem::SoundID::kCastLoop)
+);
+
 /// Like `RE::TESForm::LookupByID()` but logs on failure.
 inline RE::TESForm*
 GetForm(RE::FormID form_id) {
     auto* form = RE::TESForm::LookupByID(form_id);
     if (!form) {
-        SKSE::log::trace("unknown form {:08X}", form_id);
+        ESAS_LOG_TRACE("unknown form {:08X}", form_id);
     }
     return form;
 }
@@ -70,7 +92,7 @@ GetForm(RE::FormID form_id) {
     }
     auto* obj = form->As<T>();
     if (!obj) {
-        SKSE::log::trace("{} cannot be cast to form type {}", *form, T::FORMTYPE);
+        ESAS_LOG_TRACE("{} cannot be cast to form type {}", *form, T::FORMTYPE);
     }
     return obj;
 }
@@ -92,7 +114,7 @@ GetForm(std::string_view modname, RE::FormID local_id) {
     }
     auto* form = data_handler->LookupForm(local_id, modname);
     if (!form) {
-        SKSE::log::trace("unknown form ({}, {:08X})", modname, local_id);
+        ESAS_LOG_TRACE("unknown form ({}, {:08X})", modname, local_id);
     }
     return form;
 }
@@ -111,7 +133,7 @@ GetForm(std::string_view modname, RE::FormID local_id) {
     }
     auto* obj = form->As<T>();
     if (!obj) {
-        SKSE::log::trace("{} cannot be cast to form type {}", *form, T::FORMTYPE);
+        ESAS_LOG_TRACE("{} cannot be cast to form type {}", *form, T::FORMTYPE);
     }
     return obj;
 }
@@ -135,24 +157,39 @@ DebugNotification(std::format_string<Args...> fmt, Args&&... args) {
     RE::DebugNotification(s.c_str());
 }
 
-/// Returns false if unable to allocate a console command execution context. Returning true means
-/// the command was executed, even if that execution failed inside the console.
-template <class... Args>
-[[nodiscard]] bool
-ConsoleRun(std::format_string<Args...> fmt, Args&&... args) {
-    auto cmd = std::vformat(fmt.get(), std::make_format_args(args...));
+/// Runs console commands through a single `RE::Script`, allocated on first use.
+class ConsoleScript final {
+  public:
+    ConsoleScript() = default;
 
-    auto* fac = RE::IFormFactory::GetConcreteFormFactoryByType<RE::Script>();
-    auto* script = fac ? fac->Create() : nullptr;
-    if (!script) {
-        return false;
+    ConsoleScript(const ConsoleScript&) = delete;
+    ConsoleScript& operator=(const ConsoleScript&) = delete;
+    ConsoleScript(ConsoleScript&&) = delete;
+    ConsoleScript& operator=(ConsoleScript&&) = delete;
+
+    ~ConsoleScript() {
+        delete script_;
     }
 
-    script->SetCommand(cmd);
-    script->CompileAndRun(nullptr);
-    delete script;
-    return true;
-}
+    /// Returns false if unable to allocate a console command execution context. Returning true
+    /// means the command was executed, even if that execution failed inside the console.
+    [[nodiscard]] bool
+    Run(const std::string& cmd) {
+        if (!script_) {
+            auto* fac = RE::IFormFactory::GetConcreteFormFactoryByType<RE::Script>();
+            script_ = fac ? fac->Create() : nullptr;
+            if (!script_) {
+                return false;
+            }
+        }
+        script_->SetCommand(cmd);
+        script_->CompileAndRun(nullptr);
+        return true;
+    }
+
+  private:
+    RE::Script* script_ = nullptr;
+};
 
 /// In particular, scrolls are not considered spells.
 inline bool
@@ -186,6 +223,84 @@ GetEquippedShout(const RE::Actor& actor) {
     return form ? form->As<RE::TESShout>() : nullptr;
 }
 
+/// The shouts that `actor` has, i.e. what `RE::Actor::HasShout()` searches.
+inline std::span<RE::TESShout* const>
+GetShouts(const RE::Actor& actor) {
+    const auto* base = actor.GetActorBase();
+    const auto* spell_list = base ? base->GetSpellList() : nullptr;
+    if (!spell_list || !spell_list->shouts) {
+        return {};
+    }
+    return {spell_list->shouts, spell_list->numShouts};
+}
+
+// `TeachWord()` and `RemoveShout()` reimplement the parts of the `teachword` and `removeshout`
+// console commands that this mod needs. The engine routines behind those commands aren't exposed
+// by CommonLibSSE, and calling them through `REL::Relocation` would need Address Library IDs for
+// every supported runtime that this project has no way to verify. Instead, both functions only
+// make the state changes that CommonLibSSE itself makes for the same data, and flag the change so
+// that the game saves it.
+
+/// Does what the `teachword` console command does to `word`, minus its side effect of adding shouts
+/// that use `word` to the player. Knowing a word is nothing more than the word's `kKnown` form flag
+/// (which `RE::TESWordOfPower::GetKnown()` reads), saved as part of the form's flags change.
+inline void
+TeachWord(RE::TESWordOfPower& word) {
+    if (word.GetKnown()) {
+        return;
+    }
+    word.formFlags |= RE::TESForm::RecordFlags::kKnown;
+    word.AddChange(RE::TESForm::ChangeFlags::kFlags);
+}
+
+/// Does what the `removeshout` console command does, for every shout in `actor`'s shout list for
+/// which `pred(shout)` is true. `pred` is also called with null entries, if there are any. Returns
+/// the number of entries removed.
+///
+/// Rather than shrinking the shout list in place, this replaces it with a new, exactly sized array
+/// from the game's allocator and frees the old one to that allocator. The list's memory then always
+/// matches its count, so nothing the game later does with it (e.g. reallocating it in
+/// `RE::Actor::AddShout()`) can trip over leftover capacity.
+template <std::predicate<const RE::TESShout*> Pred>
+size_t
+RemoveShoutsIf(RE::Actor& actor, Pred pred) {
+    auto* base = actor.GetActorBase();
+    auto* spell_list = base ? base->GetSpellList() : nullptr;
+    if (!spell_list || !spell_list->shouts) {
+        return 0;
+    }
+    auto old = std::span(spell_list->shouts, spell_list->numShouts);
+    auto n = static_cast<size_t>(std::ranges::count_if(old, pred));
+    if (n == 0) {
+        return 0;
+    }
+
+    auto remaining = old.size() - n;
+    auto* shouts = remaining > 0 ? RE::calloc<RE::TESShout*>(remaining) : nullptr;
+    if (remaining > 0 && !shouts) {
+        return 0;
+    }
+    std::ranges::remove_copy_if(old, shouts, pred);
+    RE::free(spell_list->shouts);
+    spell_list->shouts = shouts;
+    spell_list->numShouts = static_cast<uint32_t>(remaining);
+    base->AddChange(RE::TESNPC::ChangeFlags::kSpellList);
+
+    auto* equipped = GetEquippedShout(actor);
+    if (equipped && pred(equipped)) {
+        if (auto* aem = RE::ActorEquipManager::GetSingleton()) {
+            aem->UnEquipShout(&actor, equipped);
+        }
+    }
+    return n;
+}
+
+/// Does what the `removeshout` console command does. Returns false if `actor` doesn't have `shout`.
+inline bool
+RemoveShout(RE::Actor& actor, RE::TESShout& shout) {
+    return RemoveShoutsIf(actor, [&shout](const RE::TESShout* s) { return s == &shout; }) > 0;
+}
+
 inline RE::HighProcessData*
 GetHighProcessData(RE::Actor& player) {
     auto* process = player.GetActorRuntimeData().currentProcess;
@@ -193,22 +308,13 @@ GetHighProcessData(RE::Actor& player) {
 }
 
 inline bool
-HasEnoughMagicka(
-    RE::Actor& actor, RE::ActorValueOwner& av_owner, const RE::SpellItem& spell, float magicka_scale
-) {
-    auto magicka = av_owner.GetActorValue(RE::ActorValue::kMagicka);
-    return spell.CalculateMagickaCost(&actor) * magicka_scale <= magicka;
+HasEnoughMagicka(RE::ActorValueOwner& av_owner, float cost) {
+    return cost <= av_owner.GetActorValue(RE::ActorValue::kMagicka);
 }
 
 inline void
-ApplyMagickaCost(
-    RE::Actor& actor, RE::ActorValueOwner& av_owner, const RE::SpellItem& spell, float magicka_scale
-) {
-    av_owner.RestoreActorValue(
-        RE::ACTOR_VALUE_MODIFIER::kDamage,
-        RE::ActorValue::kMagicka,
-        -spell.CalculateMagickaCost(&actor) * magicka_scale
-    );
+ApplyMagickaCost(RE::ActorValueOwner& av_owner, float cost) {
+    av_owner.RestoreActorValue(RE::ACTOR_VALUE_MODIFIER::kDamage, RE::ActorValue::kMagicka, -cost);
 }
 
 inline void
@@ -224,18 +330,46 @@ CastSpellImmediate(RE::Actor& actor, RE::MagicCaster& magic_caster, RE::SpellIte
     );
 }
 
-inline RE::BGSSoundDescriptorForm*
-GetSpellSound(const RE::SpellItem* spell, RE::MagicSystem::SoundID id) {
-    const auto* effect_setting = spell ? spell->GetAVEffect() : nullptr;
-    if (!effect_setting) {
-        return nullptr;
+/// Adapts `RE::SpellItem` to `CastProfileSource`.
+class SpellProfileSource final {
+  public:
+    explicit SpellProfileSource(const RE::SpellItem& spell)
+        : spell_(spell),
+          effect_setting_(spell.GetAVEffect()) {}
+
+    uint32_t
+    casting_type() const {
+        return std::to_underlying(spell_.GetCastingType());
+    }
+
+    bool
+    bound_weapon() const {
+        return effect_setting_
+               && effect_setting_->GetArchetype()
+                      == RE::EffectArchetypes::ArchetypeID::kBoundWeapon;
     }
-    for (const auto& soundpair : effect_setting->effectSounds) {
-        if (soundpair.id == id && soundpair.sound) {
-            return soundpair.sound;
+
+    std::span<const RE::EffectSetting::SoundPair>
+    effect_sounds() const {
+        if (!effect_setting_) {
+            return {};
         }
+        const auto& sounds = effect_setting_->effectSounds;
+        return {sounds.data(), sounds.size()};
     }
-    return nullptr;
+
+  private:
+    const RE::SpellItem& spell_;
+    const RE::EffectSetting* effect_setting_;
+};
+
+static_assert(CastProfileSource<SpellProfileSource, RE::BGSSoundDescriptorForm>);
+
+/// Collects what the casting path needs to know about `spell`. Call when assigning `spell`, not
+/// when casting it.
+inline SpellProfile
+GetCastProfile(const RE::SpellItem& spell) {
+    return MakeCastProfile<RE::BGSSoundDescriptorForm>(SpellProfileSource(spell));
 }
 
 /// Returns nullopt if `sound` is null.
@@ -264,20 +398,18 @@ FlashMagickaBar() {
     FlashHudMenuMeter(RE::ActorValue::kMagicka);
 }
 
+/// Empties `actor`'s hand by equipping and unequipping `dummy` (normally `kWeapDummy`) in `slot`
+/// (normally `kEqupLeftHand` or `kEqupRightHand`).
 inline void
-UnequipHand(RE::ActorEquipManager& aem, RE::Actor& actor, bool left_hand) {
-    auto equp_id = left_hand ? tes_util::kEqupLeftHand : tes_util::kEqupRightHand;
-    const auto* bgs_slot = tes_util::GetForm<RE::BGSEquipSlot>(equp_id);
-    auto* dummy = tes_util::GetForm<RE::TESObjectWEAP>(tes_util::kWeapDummy);
-    if (!bgs_slot || !dummy) {
-        SKSE::log::error(
-            "unequip hand failed: cannot look up {:08X} or {:08X}", equp_id, tes_util::kWeapDummy
-        );
-        return;
-    }
-    //                                                 queue, force, sounds, apply_now
-    aem.EquipObject(&actor, dummy, nullptr, 1, bgs_slot, false, false, false, true);
-    aem.UnequipObject(&actor, dummy, nullptr, 1, bgs_slot, false, false, false, true);
+UnequipHand(
+    RE::ActorEquipManager& aem,
+    RE::Actor& actor,
+    const RE::BGSEquipSlot& slot,
+    RE::TESObjectWEAP& dummy
+) {
+    //                                                   queue, force, sounds, apply_now
+    aem.EquipObject(&actor, &dummy, nullptr, 1, &slot, false, false, false, true);
+    aem.UnequipObject(&actor, &dummy, nullptr, 1, &slot, false, false, false, true);
 }
 
 }  // namespace tes_util
@@ -0,0 +1,106 @@
+#include "cast_profile.h"
+#include "fake_forms.h"
+
+namespace esas {
+namespace {
+
+/// Stand-in for `RE::EffectSetting::SoundPair`, with a raw ID like the game's.
+struct FakeSoundPair {
+    uint32_t id = 0;
+    const FakeSound* sound = nullptr;
+};
+
+/// Stand-in for a spell and its primary effect.
+struct FakeSpellModel {
+    uint32_t raw_casting_type = 0;
+    bool bound = false;
+    std::vector<FakeSoundPair> sounds = {};
+
+    uint32_t
+    casting_type() const {
+        return raw_casting_type;
+    }
+
+    bool
+    bound_weapon() const {
+        return bound;
+    }
+
+    std::span<const FakeSoundPair>
+    effect_sounds() const {
+        return sounds;
+    }
+};
+
+static_assert(CastProfileSource<FakeSpellModel, FakeSound>);
+
+constexpr auto kDraw = uint32_t(0);
+constexpr auto kRelease = std::to_underlying(CastSoundID::kRelease);
+constexpr auto kCastLoop = std::to_underlying(CastSoundID::kCastLoop);
+
+}  // namespace
+
+TEST_CASE("MakeCastProfile") {
+    using Profile = CastProfile<FakeSound>;
+    auto sounds = FakeForms<FakeSound>(0x2000, 4);
+
+    SECTION("no primary effect") {
+        auto spell = FakeSpellModel{.raw_casting_type = 1};
+        REQUIRE(
+            MakeCastProfile<FakeSound>(spell)
+            == Profile{.casting_type = CastingType::kFireAndForget}
+        );
+    }
+
+    SECTION("casting types") {
+        for (auto ct :
+             {CastingType::kConstantEffect,
+              CastingType::kFireAndForget,
+              CastingType::kConcentration,
+              CastingType::kScroll}) {
+            auto spell = FakeSpellModel{.raw_casting_type = std::to_underlying(ct)};
+            REQUIRE(MakeCastProfile<FakeSound>(spell).casting_type == ct);
+        }
+        // Never cast, so nothing downstream mistakes it for a castable spell.
+        auto spell = FakeSpellModel{.raw_casting_type = 7};
+        REQUIRE(MakeCastProfile<FakeSound>(spell).casting_type == CastingType::kConstantEffect);
+    }
+
+    SECTION("bound weapon") {
+        auto spell = FakeSpellModel{.raw_casting_type = 1, .bound = true};
+        REQUIRE(MakeCastProfile<FakeSound>(spell).bound_weapon);
+    }
+
+    SECTION("sounds") {
+        auto spell = FakeSpellModel{
+            .raw_casting_type = 2,
+            .sounds = {
+                {.id = kDraw, .sound = &sounds[0]},
+                {.id = kRelease, .sound = nullptr},
+                {.id = kRelease, .sound = &sounds[1]},
+                {.id = kCastLoop, .sound = &sounds[2]},
+                {.id = kRelease, .sound = &sounds[3]},
+            },
+        };
+        REQUIRE(
+            MakeCastProfile<FakeSound>(spell)
+            == Profile{
+                .casting_type = CastingType::kConcentration,
+                .release_sound = &sounds[1],
+                .loop_sound = &sounds[2],
+            }
+        );
+    }
+
+    SECTION("missing sounds") {
+        auto spell = FakeSpellModel{
+            .raw_casting_type = 1,
+            .sounds = {{.id = kDraw, .sound = &sounds[0]}, {.id = kCastLoop, .sound = nullptr}},
+        };
+        auto profile = MakeCastProfile<FakeSound>(spell);
+        REQUIRE(!profile.release_sound);
+        REQUIRE(!profile.loop_sound);
+    }
+}
+
+}  // namespace esas
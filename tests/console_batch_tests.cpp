@@ -0,0 +1,89 @@
+#include "console_batch.h"
+
+namespace esas {
+namespace {
+
+/// Records every command it's asked to compile and run.
+class FakeConsole {
+  public:
+    std::vector<std::string> compiled;
+    bool fail = false;
+
+    bool
+    Run(const std::string& cmd) {
+        if (fail) {
+            return false;
+        }
+        compiled.push_back(cmd);
+        return true;
+    }
+};
+
+static_assert(ConsoleExecutor<FakeConsole>);
+
+}  // namespace
+
+TEST_CASE("ConsoleBatch flush") {
+    auto batch = ConsoleBatch();
+    auto console = FakeConsole();
+    REQUIRE(batch.empty());
+    REQUIRE(batch.Flush(console) == 0);
+    REQUIRE(console.compiled.empty());
+
+    SECTION("teachword runs before removeshout") {
+        batch.RemoveShout(0x8ff);
+        batch.TeachWord(0x801);
+        REQUIRE(!batch.empty());
+        REQUIRE(batch.Flush(console) == 0);
+        REQUIRE(
+            console.compiled
+            == std::vector<std::string>{"player.teachword 00000801", "player.removeshout 000008ff"}
+        );
+        REQUIRE(batch.empty());
+    }
+
+    SECTION("repeated assignments coalesce") {
+        for (uint32_t shout = 0x900; shout < 0x905; shout++) {
+            batch.TeachWord(0x801);
+            batch.RemoveShout(0x8ff);
+        }
+        batch.RemoveShout(0x903);
+        batch.RemoveShout(0x903);
+        REQUIRE(batch.Flush(console) == 0);
+        REQUIRE(
+            console.compiled
+            == std::vector<std::string>{
+                "player.teachword 00000801",
+                "player.removeshout 000008ff",
+                "player.removeshout 00000903",
+            }
+        );
+    }
+
+    SECTION("cancel removal of a re-added shout") {
+        batch.RemoveShout(0x900);
+        batch.RemoveShout(0x901);
+        batch.CancelRemoveShout(0x900);
+        batch.CancelRemoveShout(0x902);
+        REQUIRE(batch.Flush(console) == 0);
+        REQUIRE(console.compiled == std::vector<std::string>{"player.removeshout 00000901"});
+    }
+
+    SECTION("failures are counted and the batch is still cleared") {
+        console.fail = true;
+        batch.TeachWord(0x801);
+        batch.RemoveShout(0x8ff);
+        REQUIRE(batch.Flush(console) == 2);
+        REQUIRE(batch.empty());
+    }
+
+    SECTION("nothing carries over between flushes") {
+        batch.TeachWord(0x801);
+        batch.Flush(console);
+        batch.TeachWord(0x801);
+        batch.Flush(console);
+        REQUIRE(console.compiled.size() == 2);
+    }
+}
+
+}  // namespace esas
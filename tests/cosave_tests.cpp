@@ -0,0 +1,123 @@
+#include "cosave.h"
+
+namespace esas {
+namespace cosave {
+namespace {
+
+ShoutmapIR
+RandomIR(std::mt19937& rng, size_t n) {
+    auto ir = ShoutmapIR();
+    for (size_t i = 0; i < n; i++) {
+        ir.emplace_back(0x900 + static_cast<uint32_t>(i), static_cast<uint32_t>(rng()));
+    }
+    return ir;
+}
+
+std::span<const std::byte>
+AsBytes(std::string_view s) {
+    return std::as_bytes(std::span(s.data(), s.size()));
+}
+
+}  // namespace
+
+TEST_CASE("cosave Crc32") {
+    REQUIRE(Crc32({}) == 0);
+    REQUIRE(Crc32(AsBytes("123456789")) == 0xcbf43926);
+}
+
+TEST_CASE("cosave binary round trip") {
+    auto rng = std::mt19937(GENERATE(1u, 2u));
+    auto n = GENERATE(0u, 1u, 30u, 5000u);
+    auto ir = RandomIR(rng, n);
+
+    auto buf = std::vector<std::byte>();
+    EncodeShoutmapIR(ir, buf);
+    REQUIRE(buf.size() == kBinaryHeaderSize + n * kBinaryPairSize);
+
+    auto got = DecodeShoutmapIR(kVersionBinary, buf);
+    REQUIRE(got);
+    REQUIRE(*got == ir);
+}
+
+TEST_CASE("cosave binary layout is little-endian") {
+    auto buf = std::vector<std::byte>();
+    EncodeShoutmapIR({{0x00000901, 0x0a0b0c0d}}, buf);
+    REQUIRE(buf.size() == 16);
+
+    auto want_pair = std::array<uint8_t, 8>{0x01, 0x09, 0x00, 0x00, 0x0d, 0x0c, 0x0b, 0x0a};
+    auto crc = Crc32(std::as_bytes(std::span(want_pair)));
+    auto want = std::vector<uint8_t>{1, 0, 0, 0};
+    for (int i = 0; i < 4; i++) {
+        want.push_back(static_cast<uint8_t>(crc >> (8 * i)));
+    }
+    want.insert(want.end(), want_pair.cbegin(), want_pair.cend());
+
+    auto got = std::vector<uint8_t>();
+    for (auto b : buf) {
+        got.push_back(static_cast<uint8_t>(b));
+    }
+    REQUIRE(got == want);
+}
+
+TEST_CASE("cosave decodes version 1 JSON records") {
+    auto ir = DecodeShoutmapIR(kVersionJson, AsBytes("[[2304,1234],[2305,5678]]"));
+    REQUIRE(ir);
+    REQUIRE(*ir == ShoutmapIR{{0x900, 1234}, {0x901, 5678}});
+
+    REQUIRE(!DecodeShoutmapIR(kVersionJson, AsBytes("[[2304,")));
+}
+
+TEST_CASE("cosave rejects unknown versions") {
+    auto buf = std::vector<std::byte>();
+    EncodeShoutmapIR({{0x900, 1}}, buf);
+    REQUIRE(!DecodeShoutmapIR(0, buf));
+    REQUIRE(!DecodeShoutmapIR(kVersionBinary + 1, buf));
+}
+
+TEST_CASE("cosave fuzz corrupted binary records") {
+    auto rng = std::mt19937(GENERATE(1u, 2u, 3u, 4u));
+    auto ir = RandomIR(rng, rng() % 40 + 1);
+    auto buf = std::vector<std::byte>();
+    EncodeShoutmapIR(ir, buf);
+
+    for (int iter = 0; iter < 2000; iter++) {
+        auto corrupt = buf;
+        switch (rng() % 3) {
+            case 0: {  // Any single-byte change is caught by the length check or the checksum.
+                auto i = rng() % corrupt.size();
+                corrupt[i] ^= static_cast<std::byte>(rng() % 255 + 1);
+                break;
+            }
+            case 1:  // truncate
+                corrupt.resize(rng() % corrupt.size());
+                break;
+            case 2:  // extend
+                corrupt.resize(corrupt.size() + rng() % 16 + 1, static_cast<std::byte>(rng()));
+                break;
+        }
+        CAPTURE(iter);
+        REQUIRE(!DecodeShoutmapIR(kVersionBinary, corrupt));
+    }
+}
+
+TEST_CASE("cosave fuzz random bytes") {
+    auto rng = std::mt19937(GENERATE(1u, 2u));
+    for (int iter = 0; iter < 5000; iter++) {
+        auto data = std::vector<std::byte>(rng() % 64);
+        for (auto& b : data) {
+            b = static_cast<std::byte>(rng());
+        }
+        // Must not crash. Whatever decodes must re-encode to the same bytes.
+        for (auto version : {kVersionJson, kVersionBinary}) {
+            auto ir = DecodeShoutmapIR(version, data);
+            if (ir && version == kVersionBinary) {
+                auto buf = std::vector<std::byte>();
+                EncodeShoutmapIR(*ir, buf);
+                REQUIRE(buf == data);
+            }
+        }
+    }
+}
+
+}  // namespace cosave
+}  // namespace esas
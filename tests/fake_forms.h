@@ -0,0 +1,64 @@
+#pragma once
+
+#include "adapters.h"
+
+namespace esas {
+
+/// Stand-in for any `RE::TESForm` subclass.
+struct FakeForm {
+    uint32_t id = 0;
+
+    uint32_t
+    GetFormID() const {
+        return id;
+    }
+};
+
+/// Distinct types, like `RE::TESShout` and `RE::SpellItem`, so that overloads on them resolve.
+struct FakeShout : FakeForm {};
+struct FakeSpell : FakeForm {};
+struct FakeSound : FakeForm {};
+
+/// Stand-in for `RE::Actor`, tracking which shouts it has.
+struct FakeActor {
+    std::unordered_set<const FakeShout*> shouts;
+
+    bool
+    HasShout(const FakeShout* shout) const {
+        return shouts.contains(shout);
+    }
+};
+
+static_assert(FormLike<FakeShout>);
+static_assert(FormLike<FakeSpell>);
+static_assert(ShoutHolder<FakeActor, FakeShout>);
+
+/// Owns forms with consecutive form IDs, like the shouts in this mod's plugin.
+template <typename T>
+class FakeForms {
+  public:
+    FakeForms(uint32_t first_id, size_t n) : forms_(n) {
+        for (size_t i = 0; i < n; i++) {
+            forms_[i].id = first_id + static_cast<uint32_t>(i);
+        }
+    }
+
+    T&
+    operator[](size_t i) {
+        return forms_[i];
+    }
+
+    std::vector<T*>
+    ptrs() {
+        auto v = std::vector<T*>();
+        for (auto& form : forms_) {
+            v.push_back(&form);
+        }
+        return v;
+    }
+
+  private:
+    std::vector<T> forms_;
+};
+
+}  // namespace esas
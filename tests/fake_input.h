@@ -0,0 +1,115 @@
+#pragma once
+
+#include "input.h"
+
+namespace esas {
+
+/// Mirrors the `RE::ButtonEvent` accessors that input decoding uses.
+struct FakeButton {
+    uint32_t idcode = 0;
+    InputDevice device = InputDevice::kKeyboard;
+    float value = 0.f;
+    float heldsecs = 0.f;
+
+    bool
+    HasIDCode() const {
+        return true;
+    }
+
+    uint32_t
+    GetIDCode() const {
+        return idcode;
+    }
+
+    InputDevice
+    GetDevice() const {
+        return device;
+    }
+
+    bool
+    IsPressed() const {
+        return value > 0.f;
+    }
+
+    bool
+    IsUp() const {
+        return value == 0.f && heldsecs > 0.f;
+    }
+
+    float
+    HeldDuration() const {
+        return heldsecs;
+    }
+};
+
+/// Mirrors `RE::InputEvent`. Non-button events (e.g. mouse moves) have no button.
+struct FakeEvent {
+    const FakeEvent* next = nullptr;
+    std::optional<FakeButton> button;
+
+    const FakeButton*
+    AsButtonEvent() const {
+        return button ? &*button : nullptr;
+    }
+};
+
+/// Owns a linked chain of fake events.
+class FakeEventChain {
+  public:
+    explicit FakeEventChain(std::vector<FakeEvent> events) : events_(std::move(events)) {
+        for (size_t i = 0; i + 1 < events_.size(); i++) {
+            events_[i].next = &events_[i + 1];
+        }
+    }
+
+    const FakeEvent*
+    head() const {
+        return events_.empty() ? nullptr : &events_.front();
+    }
+
+  private:
+    std::vector<FakeEvent> events_;
+};
+
+/// String-keyed lookup, like `RE::ControlMap::GetMappedKey()`.
+class FakeControlMap {
+  public:
+    mutable size_t lookups = 0;
+
+    FakeControlMap() {
+        mapped_["Shout"] = {44, 3, 0x0200};  // Z, Mouse4, GamepadRB
+        for (auto name : {"Forward", "Back", "Strafe Left", "Strafe Right", "Jump", "Sprint"}) {
+            mapped_[name] = {0xff, 0xff, 0xff};
+        }
+    }
+
+    void
+    Remap(std::string_view user_event, InputDevice device, uint32_t idcode) {
+        mapped_.find(user_event)->second[std::to_underlying(device)] = idcode;
+    }
+
+    uint32_t
+    GetMappedKey(std::string_view user_event, InputDevice device) const {
+        lookups++;
+        auto it = mapped_.find(user_event);
+        auto i = static_cast<size_t>(std::to_underlying(device));
+        return it == mapped_.end() || i >= it->second.size() ? 0xff : it->second[i];
+    }
+
+  private:
+    std::map<std::string, std::array<uint32_t, 3>, std::less<>> mapped_;
+};
+
+inline FakeEvent
+Key(uint32_t idcode, float heldsecs, bool released = false) {
+    return {
+        .button = FakeButton{
+            .idcode = idcode,
+            .device = InputDevice::kKeyboard,
+            .value = released ? 0.f : 1.f,
+            .heldsecs = heldsecs,
+        },
+    };
+}
+
+}  // namespace esas
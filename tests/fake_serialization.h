@@ -0,0 +1,94 @@
+#pragma once
+
+namespace esas {
+
+/// In-memory stand-in for `SKSE::SerializationInterface`. Written records can be read back after
+/// calling `Rewind()`, like a save followed by a load.
+class FakeSerialization final {
+  public:
+    struct Record {
+        uint32_t type = 0;
+        uint32_t version = 0;
+        std::vector<std::byte> data;
+    };
+
+    /// Old form ID -> new form ID. Form IDs not in this map fail to resolve, like forms from an
+    /// uninstalled mod.
+    std::unordered_map<uint32_t, uint32_t> form_id_remap;
+    mutable std::vector<Record> records;
+
+    mutable size_t read_calls = 0;
+    mutable size_t write_calls = 0;
+
+    /// Restarts reading from the first record.
+    void
+    Rewind() {
+        next_record_ = 0;
+        read_offset_ = 0;
+        opened_ = false;
+    }
+
+    bool
+    OpenRecord(uint32_t type, uint32_t version) const {
+        records.push_back({.type = type, .version = version, .data = {}});
+        opened_ = true;
+        return true;
+    }
+
+    bool
+    WriteRecordData(const void* buf, uint32_t length) const {
+        write_calls++;
+        if (!opened_) {
+            return false;
+        }
+        const auto* p = static_cast<const std::byte*>(buf);
+        records.back().data.insert(records.back().data.end(), p, p + length);
+        return true;
+    }
+
+    bool
+    GetNextRecordInfo(uint32_t& type, uint32_t& version, uint32_t& length) const {
+        if (next_record_ >= records.size()) {
+            return false;
+        }
+        const auto& rec = records[next_record_];
+        type = rec.type;
+        version = rec.version;
+        length = static_cast<uint32_t>(rec.data.size());
+        current_record_ = next_record_++;
+        read_offset_ = 0;
+        return true;
+    }
+
+    uint32_t
+    ReadRecordData(void* buf, uint32_t length) const {
+        read_calls++;
+        if (current_record_ >= records.size()) {
+            return 0;
+        }
+        const auto& data = records[current_record_].data;
+        auto n = std::min<size_t>(length, data.size() - read_offset_);
+        std::memcpy(buf, data.data() + read_offset_, n);
+        read_offset_ += n;
+        return static_cast<uint32_t>(n);
+    }
+
+    bool
+    ResolveFormID(uint32_t old_id, uint32_t& new_id) const {
+        auto it = form_id_remap.find(old_id);
+        if (it == form_id_remap.end()) {
+            return false;
+        }
+        new_id = it->second;
+        return true;
+    }
+
+  private:
+    // SKSE's interface is all const member functions, so the fake's state has to be mutable.
+    mutable bool opened_ = false;
+    mutable size_t next_record_ = 0;
+    mutable size_t current_record_ = std::numeric_limits<size_t>::max();
+    mutable size_t read_offset_ = 0;
+};
+
+}  // namespace esas
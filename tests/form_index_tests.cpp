@@ -0,0 +1,59 @@
+#include "form_index.h"
+
+namespace esas {
+
+TEST_CASE("FormIndex insert/find/erase") {
+    auto index = FormIndex();
+    REQUIRE(index.Find(0x900) == FormIndex::kNotFound);
+    REQUIRE(!index.Erase(0x900));
+
+    index.Insert(0x900, 0);
+    index.Insert(0x901, 1);
+    index.Insert(0, 2);  // ignored
+    REQUIRE(index.size() == 2);
+    REQUIRE(index.Find(0x900) == 0);
+    REQUIRE(index.Find(0x901) == 1);
+    REQUIRE(index.Find(0) == FormIndex::kNotFound);
+
+    index.Insert(0x900, 5);
+    REQUIRE(index.size() == 2);
+    REQUIRE(index.Find(0x900) == 5);
+
+    REQUIRE(index.Erase(0x900));
+    REQUIRE(!index.Erase(0x900));
+    REQUIRE(index.size() == 1);
+    REQUIRE(index.Find(0x900) == FormIndex::kNotFound);
+    REQUIRE(index.Find(0x901) == 1);
+
+    index.Clear();
+    REQUIRE(index.empty());
+    REQUIRE(index.Find(0x901) == FormIndex::kNotFound);
+}
+
+TEST_CASE("FormIndex matches reference map under churn") {
+    auto index = FormIndex(30);
+    auto want = std::unordered_map<uint32_t, uint32_t>();
+    auto rng = std::mt19937(GENERATE(1u, 2u, 3u));
+    // Small key space so that inserts, overwrites and erases all collide frequently.
+    auto key_dist = std::uniform_int_distribution<uint32_t>(1, 200);
+
+    for (uint32_t step = 0; step < 20000; step++) {
+        auto key = 0x0a000000 | key_dist(rng);
+        if (rng() % 3 == 0) {
+            REQUIRE(index.Erase(key) == (want.erase(key) > 0));
+        } else {
+            index.Insert(key, step);
+            want[key] = step;
+        }
+    }
+
+    REQUIRE(index.size() == want.size());
+    for (uint32_t k = 0; k <= 201; k++) {
+        auto key = 0x0a000000 | k;
+        auto it = want.find(key);
+        CAPTURE(key);
+        REQUIRE(index.Find(key) == (it == want.end() ? FormIndex::kNotFound : it->second));
+    }
+}
+
+}  // namespace esas
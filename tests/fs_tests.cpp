@@ -1,6 +1,10 @@
 #include "fs.h"
 #include "test_util.h"
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
 namespace esas {
 namespace fs {
 
@@ -17,6 +21,71 @@ TEST_CASE("fs ReadFile/WriteFile") {
     REQUIRE(*read_contents == contents);
 }
 
+TEST_CASE("fs FileContents") {
+    auto td = Tempdir();
+
+    SECTION("empty") {
+        auto fp = td.path() + "/empty.txt";
+        REQUIRE(WriteFile(fp, ""));
+        auto contents = FileContents::Read(fp);
+        REQUIRE(contents);
+        REQUIRE(contents->size() == 0);
+        REQUIRE(contents->view().empty());
+        REQUIRE(ReadFile(fp) == "");
+    }
+
+    SECTION("large") {
+        auto fp = td.path() + "/large.bin";
+        auto data = std::string(8 << 20, '\0');
+        for (size_t i = 0; i < data.size(); i++) {
+            data[i] = static_cast<char>(i * 7 + i / 4096);
+        }
+        REQUIRE(WriteFile(fp, data));
+        auto contents = FileContents::Read(fp);
+        REQUIRE(contents);
+        REQUIRE(contents->size() == data.size());
+        REQUIRE(contents->view() == data);
+    }
+
+    SECTION("line endings are left as is") {
+        auto fp = td.path() + "/crlf.txt";
+        {
+            auto f = std::ofstream(fp, std::ios::binary);
+            f << "a\r\nb\r\n";
+        }
+        auto contents = FileContents::Read(fp);
+        REQUIRE(contents);
+        REQUIRE(contents->view() == "a\r\nb\r\n");
+    }
+
+    SECTION("unreadable") {
+        REQUIRE(!FileContents::Read(td.path() + "/nonexistent.txt"));
+        REQUIRE(!FileContents::Read(td.path()));
+        REQUIRE(!ReadFile(td.path()));
+
+#ifndef _WIN32
+        // Windows has no way to deny reads through `std::filesystem::permissions()`, and root
+        // ignores permission bits.
+        if (geteuid() != 0) {
+            auto fp = td.path() + "/denied.txt";
+            REQUIRE(WriteFile(fp, "contents"));
+            std::filesystem::permissions(fp, std::filesystem::perms::none);
+            REQUIRE(!FileContents::Read(fp));
+            REQUIRE(!ReadFile(fp));
+        }
+#endif
+    }
+
+    SECTION("outlives moves") {
+        auto fp = td.path() + "/moved.txt";
+        REQUIRE(WriteFile(fp, "contents"));
+        auto contents = FileContents::Read(fp);
+        REQUIRE(contents);
+        auto moved = std::move(*contents);
+        REQUIRE(moved.view() == "contents");
+    }
+}
+
 TEST_CASE("fs RemoveFile") {
     auto td = Tempdir();
 
@@ -0,0 +1,85 @@
+#include "input.h"
+#include "fake_input.h"
+
+namespace esas {
+
+TEST_CASE("InputFrame decode") {
+    auto cm = FakeControlMap();
+    auto shout_key = [&](InputDevice device) { return cm.GetMappedKey("Shout", device); };
+    auto frame = InputFrame();
+
+    SECTION("null chain") {
+        InputFrame::Decode<FakeEvent>(nullptr, shout_key, frame);
+        REQUIRE(frame.keystrokes().empty());
+        REQUIRE(frame.shout_button() == ShoutButton::kAbsent);
+    }
+
+    SECTION("keys and shout held") {
+        auto chain = FakeEventChain({
+            FakeEvent{},  // not a button
+            Key(42, 1.f),
+            Key(13, 0.f),
+            Key(44, .2f),
+            Key(2, .5f, /*released=*/true),
+        });
+        InputFrame::Decode(chain.head(), shout_key, frame);
+        REQUIRE(frame.shout_button() == ShoutButton::kDown);
+        REQUIRE(frame.keystroke_list().size() == 3);
+        REQUIRE(frame.keystrokes().pressed().count() == 3);
+        REQUIRE(frame.keystrokes().heldsecs(42) == 1.f);
+        auto keysets = Keysets(std::vector<Keyset>{{42, 13}});
+        REQUIRE(keysets.Match(frame.keystrokes()) == Keypress::kPress);
+    }
+
+    SECTION("shout released") {
+        auto chain = FakeEventChain({Key(44, 1.f, /*released=*/true)});
+        InputFrame::Decode(chain.head(), shout_key, frame);
+        REQUIRE(frame.shout_button() == ShoutButton::kUp);
+        REQUIRE(frame.keystrokes().empty());
+    }
+
+    SECTION("first shout event wins") {
+        auto chain = FakeEventChain({Key(44, 1.f, /*released=*/true), Key(44, 0.f)});
+        InputFrame::Decode(chain.head(), shout_key, frame);
+        REQUIRE(frame.shout_button() == ShoutButton::kUp);
+    }
+}
+
+TEST_CASE("MappedKeyCache") {
+    auto cm = FakeControlMap();
+    auto cache = MappedKeyCache("Shout");
+
+    REQUIRE(cache.Get(cm, InputDevice::kKeyboard) == 44);
+    REQUIRE(cache.Get(cm, InputDevice::kKeyboard) == 44);
+    REQUIRE(cache.Get(cm, InputDevice::kMouse) == 3);
+    REQUIRE(cache.Get(cm, InputDevice::kMouse) == 3);
+    REQUIRE(cm.lookups == 2);
+
+    SECTION("stale until invalidated") {
+        cm.Remap("Shout", InputDevice::kKeyboard, 45);
+        REQUIRE(cache.Get(cm, InputDevice::kKeyboard) == 44);
+        REQUIRE(cm.lookups == 2);
+
+        cache.Invalidate();
+        REQUIRE(cache.Get(cm, InputDevice::kKeyboard) == 45);
+        REQUIRE(cache.Get(cm, InputDevice::kMouse) == 3);
+        REQUIRE(cm.lookups == 4);
+        REQUIRE(cache.Get(cm, InputDevice::kKeyboard) == 45);
+        REQUIRE(cm.lookups == 4);
+    }
+
+    SECTION("invalidate from another thread") {
+        cm.Remap("Shout", InputDevice::kKeyboard, 45);
+        std::jthread([&]() { cache.Invalidate(); }).join();
+        REQUIRE(cache.Get(cm, InputDevice::kKeyboard) == 45);
+    }
+
+    SECTION("unknown devices are not cached") {
+        auto device = static_cast<InputDevice>(7);
+        REQUIRE(cache.Get(cm, device) == 0xff);
+        REQUIRE(cache.Get(cm, device) == 0xff);
+        REQUIRE(cm.lookups == 4);
+    }
+}
+
+}  // namespace esas
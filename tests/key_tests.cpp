@@ -1,6 +1,50 @@
 #include "keys.h"
+#include "random_keys.h"
+#include "reference_keys.h"
 
 namespace esas {
+namespace {
+
+constexpr bool
+AllKeycodeNamesRoundTrip() {
+    for (uint32_t i = 0; i < kKeycodeNames.size(); i++) {
+        auto name = KeycodeName(i);
+        if (name.empty()) {
+            continue;
+        }
+        if (KeycodeFromName(name) != i || KeycodeFromNameLoose(name) != i) {
+            return false;
+        }
+
+        auto upper = std::array<char, 32>();
+        for (size_t j = 0; j < name.size(); j++) {
+            auto c = name[j];
+            upper[j] = c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c;
+        }
+        if (KeycodeFromNameLoose(std::string_view(upper.data(), name.size())) != i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr bool
+AllKeycodeAliasesResolve() {
+    for (auto [alias, keycode] : kKeycodeAliases) {
+        if (!KeycodeIsValid(keycode) || KeycodeFromNameLoose(alias) != keycode
+            || KeycodeFromName(alias) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(AllKeycodeNamesRoundTrip());
+static_assert(AllKeycodeAliasesResolve());
+static_assert(KeycodeFromName("") == 0);
+static_assert(KeycodeFromNameLoose("") == 0);
+
+}  // namespace
 
 TEST_CASE("Keycode from name") {
     struct Testcase {
@@ -19,6 +63,42 @@ TEST_CASE("Keycode from name") {
 
     auto got = KeycodeFromName(testcase.name);
     REQUIRE(got == testcase.want);
+    REQUIRE(got == KeycodeFromNameLinear(testcase.name));
+}
+
+TEST_CASE("Keycode from name loose") {
+    struct Testcase {
+        std::string_view name;
+        uint32_t want;
+    };
+
+    auto testcase = GENERATE(
+        Testcase{.name = "", .want = 0},
+        Testcase{.name = "081i3nof09", .want = 0},
+        Testcase{.name = "LShift", .want = 42},
+        Testcase{.name = "lshift", .want = 42},
+        Testcase{.name = "GamEPADrt", .want = 281},
+        Testcase{.name = "LeftShift", .want = 42},
+        Testcase{.name = "leftshift", .want = 42},
+        Testcase{.name = "Minus", .want = 12},
+        Testcase{.name = "Left Shift", .want = 0},
+        Testcase{.name = "LShift ", .want = 0}
+    );
+
+    auto got = KeycodeFromNameLoose(testcase.name);
+    REQUIRE(got == testcase.want);
+}
+
+TEST_CASE("Keycode from scancode") {
+    REQUIRE(KeycodeFromScancode(42, InputDevice::kKeyboard) == KeycodeFromName("LShift"));
+    REQUIRE(KeycodeFromScancode(0, InputDevice::kMouse) == KeycodeFromName("LMouse"));
+    REQUIRE(KeycodeFromScancode(9, InputDevice::kMouse) == KeycodeFromName("MWheelDown"));
+    REQUIRE(KeycodeFromScancode(0x0001, InputDevice::kGamepad) == KeycodeFromName("DpadUp"));
+    REQUIRE(KeycodeFromScancode(0x0200, InputDevice::kGamepad) == KeycodeFromName("GamepadRB"));
+    REQUIRE(KeycodeFromScancode(0x8000, InputDevice::kGamepad) == KeycodeFromName("GamepadY"));
+    REQUIRE(KeycodeFromScancode(0x000a, InputDevice::kGamepad) == KeycodeFromName("GamepadRT"));
+    REQUIRE(KeycodeFromScancode(0x0400, InputDevice::kGamepad) == 0);
+    REQUIRE(KeycodeFromScancode(42, InputDevice::kVirtualKeyboard) == 0);
 }
 
 TEST_CASE("Keystroke ctor") {
@@ -218,4 +298,34 @@ TEST_CASE("Keysets match") {
     REQUIRE(got == testcase.want);
 }
 
+TEST_CASE("Keysets match agrees with linear matcher") {
+    auto rng = std::mt19937(GENERATE(1u, 2u, 3u));
+    auto all = ValidKeycodes();
+    // A narrow pool makes partial and full keyset matches both common.
+    auto pool = std::span<const uint32_t>(all).first(12);
+
+    for (int iter = 0; iter < 2000; iter++) {
+        auto keysets = RandomKeysets(rng, pool, rng() % 6);
+        auto keystrokes = RandomKeystrokes(rng, pool, rng() % 10);
+        CAPTURE(iter, keysets.vec());
+        REQUIRE(keysets.Match(keystrokes) == MatchLinear(keysets, keystrokes));
+    }
+}
+
+TEST_CASE("KeystrokeFrame first keystroke wins") {
+    auto frame = KeystrokeFrame();
+    auto keystrokes = std::vector{
+        *Keystroke::New(2, 1.f),
+        *Keystroke::New(2, 0.f),
+    };
+    frame.Fold(keystrokes);
+    REQUIRE(frame.pressed().count() == 1);
+    REQUIRE(frame.heldsecs(2) == 1.f);
+    REQUIRE(Keysets(std::vector<Keyset>{{2}}).Match(frame) == Keypress::kHold);
+
+    frame.Fold({});
+    REQUIRE(frame.empty());
+    REQUIRE(Keysets(std::vector<Keyset>{{2}}).Match(frame) == Keypress::kNone);
+}
+
 }  // namespace esas
@@ -0,0 +1,188 @@
+#include "loadout.h"
+#include "fake_forms.h"
+#include "test_util.h"
+
+namespace esas {
+namespace {
+
+using FakeSlots = ShoutSlots<FakeShout, FakeSpell>;
+
+/// Assigns `spell` to slot `i` and records the player as having its shout.
+void
+SetOwned(FakeSlots& slots, size_t i, FakeSpell* spell) {
+    slots.Set(i, spell);
+    slots.SetOwned(i, true);
+}
+
+}  // namespace
+
+TEST_CASE("LoadoutNameFromStr") {
+    REQUIRE(LoadoutNameFromStr("Prisoner") == "Prisoner");
+    REQUIRE(LoadoutNameFromStr("Lydia the Housecarl") == "Lydia the Housecarl");
+    REQUIRE(LoadoutNameFromStr(R"(a<b>c:d"e/f\g|h?i*j)") == "a_b_c_d_e_f_g_h_i_j");
+    REQUIRE(LoadoutNameFromStr("tab\there") == "tab_here");
+    REQUIRE(LoadoutNameFromStr("  .hidden. ") == "hidden");
+    auto cyrillic = std::string_view("\xd0\x98\xd0\xb2\xd0\xb0\xd0\xbd");
+    REQUIRE(LoadoutNameFromStr(cyrillic) == cyrillic);
+    REQUIRE(LoadoutNameFromStr("") == "_");
+    REQUIRE(LoadoutNameFromStr(". .") == "_");
+
+    SECTION("reserved device names") {
+        auto reserved = std::vector<std::pair<std::string_view, std::string_view>>{
+            {"CON", "_CON"},
+            {"prn", "_prn"},
+            {"Aux", "_Aux"},
+            {"nul", "_nul"},
+            {"COM1", "_COM1"},
+            {"com9", "_com9"},
+            {"LPT1", "_LPT1"},
+            {"lpt9", "_lpt9"},
+            {"NUL.txt", "_NUL.txt"},
+            {"con.a.b", "_con.a.b"},
+            {"AUX .json", "_AUX .json"},
+            {" nul. ", "_nul"},
+        };
+        for (auto [s, want] : reserved) {
+            CAPTURE(s);
+            REQUIRE(LoadoutNameFromStr(s) == want);
+        }
+
+        for (auto ok : {"CONSOLE", "Connor", "COM", "COM0", "LPT10", "xNUL", "NUL_", "a.CON"}) {
+            CAPTURE(ok);
+            REQUIRE(LoadoutNameFromStr(ok) == ok);
+        }
+    }
+}
+
+TEST_CASE("Loadout save/load/list") {
+    auto td = Tempdir();
+    auto dir = td.path() + "/loadouts";
+
+    REQUIRE(ListLoadouts(dir) == std::vector<std::string>());
+    REQUIRE(!LoadLoadout(dir, "Prisoner"));
+
+    auto mage = Loadout{
+        .spells = {
+            {.modname = "Skyrim.esm", .id = 0x12fcd},
+            {.modname = "Some Mod.esp", .id = 0x801},
+            {.modname = "", .id = 0xff000abc},
+        },
+    };
+    REQUIRE(SaveLoadout(dir, "Prisoner", mage));
+    REQUIRE(SaveLoadout(dir, "Empty", Loadout()));
+    REQUIRE(fs::WriteFile(dir + "/notes.txt", "not a loadout"));
+    REQUIRE(ListLoadouts(dir) == std::vector<std::string>{"Empty", "Prisoner"});
+    REQUIRE(LoadLoadout(dir, "Prisoner") == mage);
+    REQUIRE(LoadLoadout(dir, "Empty") == Loadout());
+
+    // Overwrite.
+    mage.spells.pop_back();
+    REQUIRE(SaveLoadout(dir, "Prisoner", mage));
+    REQUIRE(LoadLoadout(dir, "Prisoner") == mage);
+
+    SECTION("hand-edited files") {
+        REQUIRE(fs::WriteFile(dir + "/Edited.json", R"({
+            // Comments and trailing commas are allowed.
+            "spells": [
+                {"mod": "Skyrim.esm", "id": 77773},
+                {"mod": "Skyrim.esm"},
+                {"mod": 5, "id": 1},
+                {"mod": "Skyrim.esm", "id": -1},
+                ["Skyrim.esm", 1],
+                {"mod": "Update.esm", "id": 2, "extra": true},
+            ],
+        })"));
+        REQUIRE(
+            LoadLoadout(dir, "Edited")
+            == Loadout{
+                .spells = {
+                    {.modname = "Skyrim.esm", .id = 77773},
+                    {.modname = "Update.esm", .id = 2},
+                },
+            }
+        );
+
+        REQUIRE(fs::WriteFile(dir + "/Bad.json", R"({"spells": [)"));
+        REQUIRE(!LoadLoadout(dir, "Bad"));
+        REQUIRE(fs::WriteFile(dir + "/Bad.json", R"([{"mod": "Skyrim.esm", "id": 1}])"));
+        REQUIRE(!LoadLoadout(dir, "Bad"));
+    }
+}
+
+TEST_CASE("DiffLoadout") {
+    auto shouts = FakeForms<FakeShout>(0x900, 6);
+    auto spells = FakeForms<FakeSpell>(0x1000, 8);
+    auto slots = FakeSlots(shouts.ptrs());
+
+    SECTION("empty slots") {
+        auto diff = DiffLoadout(slots, {&spells[0], &spells[1]});
+        REQUIRE(diff.reassign.empty());
+        REQUIRE(diff.unassign.empty());
+        REQUIRE(diff.assign == std::vector{&spells[0], &spells[1]});
+    }
+
+    SECTION("already applied") {
+        SetOwned(slots, 0, &spells[0]);
+        SetOwned(slots, 3, &spells[1]);
+        auto diff = DiffLoadout(slots, {&spells[1], &spells[0]});
+        REQUIRE(diff.reassign.empty());
+        REQUIRE(diff.unassign.empty());
+        REQUIRE(diff.assign.empty());
+    }
+
+    SECTION("freed slots go to new spells first") {
+        SetOwned(slots, 0, &spells[0]);
+        SetOwned(slots, 1, &spells[1]);
+        SetOwned(slots, 2, &spells[2]);
+
+        SECTION("more new spells than freed slots") {
+            auto diff = DiffLoadout(slots, {&spells[1], &spells[3], &spells[4], &spells[5]});
+            REQUIRE(
+                diff.reassign
+                == std::vector<std::pair<size_t, FakeSpell*>>{{0, &spells[3]}, {2, &spells[4]}}
+            );
+            REQUIRE(diff.unassign.empty());
+            REQUIRE(diff.assign == std::vector{&spells[5]});
+        }
+
+        SECTION("fewer new spells than freed slots") {
+            auto diff = DiffLoadout(slots, {&spells[3]});
+            REQUIRE(diff.reassign == std::vector<std::pair<size_t, FakeSpell*>>{{0, &spells[3]}});
+            REQUIRE(diff.unassign == std::vector<size_t>{1, 2});
+            REQUIRE(diff.assign.empty());
+        }
+
+        SECTION("empty loadout") {
+            auto diff = DiffLoadout(slots, {});
+            REQUIRE(diff.reassign.empty());
+            REQUIRE(diff.unassign == std::vector<size_t>{0, 1, 2});
+            REQUIRE(diff.assign.empty());
+        }
+    }
+
+    SECTION("unowned slots") {
+        // Slot 0's shout was lost, so its spell must be given back. Slot 1 is owned but its spell
+        // is not in the loadout.
+        slots.Set(0, &spells[0]);
+        SetOwned(slots, 1, &spells[1]);
+        // Not in the loadout, and unowned, so there's nothing to take away.
+        slots.Set(2, &spells[2]);
+
+        auto diff = DiffLoadout(slots, {&spells[0], &spells[3]});
+        REQUIRE(diff.reassign == std::vector<std::pair<size_t, FakeSpell*>>{{1, &spells[3]}});
+        REQUIRE(diff.unassign.empty());
+        REQUIRE(diff.assign == std::vector{&spells[0]});
+    }
+
+    SECTION("null and repeated spells") {
+        SetOwned(slots, 0, &spells[0]);
+        auto diff = DiffLoadout(
+            slots, {nullptr, &spells[3], &spells[0], &spells[3], nullptr, &spells[0], &spells[4]}
+        );
+        REQUIRE(diff.reassign.empty());
+        REQUIRE(diff.unassign.empty());
+        REQUIRE(diff.assign == std::vector{&spells[3], &spells[4]});
+    }
+}
+
+}  // namespace esas
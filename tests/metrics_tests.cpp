@@ -0,0 +1,122 @@
+#include "metrics.h"
+
+namespace esas {
+namespace metrics {
+
+TEST_CASE("Histogram summary") {
+    auto h = Histogram();
+    REQUIRE(h.Summarize().count == 0);
+
+    for (uint64_t ns = 1; ns <= 100; ns++) {
+        h.Record(ns);
+    }
+    h.Record(5000);
+
+    auto s = h.Summarize();
+    REQUIRE(s.count == 101);
+    REQUIRE(s.mean_ns == (5050 + 5000) / 101);
+    REQUIRE(s.max_ns == 5000);
+    // 51st smallest is 51, which falls in [32, 64).
+    REQUIRE(s.p50_ns == 64);
+    // 100th smallest is 100, which falls in [64, 128).
+    REQUIRE(s.p99_ns == 128);
+
+    h.Reset();
+    REQUIRE(h.Summarize().count == 0);
+    REQUIRE(h.Summarize().max_ns == 0);
+}
+
+TEST_CASE("Histogram zero and huge durations") {
+    auto h = Histogram();
+    h.Record(0);
+    h.Record(std::numeric_limits<uint64_t>::max());
+    auto s = h.Summarize();
+    REQUIRE(s.count == 2);
+    REQUIRE(s.p50_ns == 0);
+    REQUIRE(s.p99_ns == uint64_t(1) << (Histogram::kBuckets - 1));
+    REQUIRE(s.max_ns == std::numeric_limits<uint64_t>::max());
+}
+
+TEST_CASE("Histogram concurrent record") {
+    auto h = Histogram();
+    {
+        auto threads = std::vector<std::jthread>();
+        for (uint64_t t = 0; t < 4; t++) {
+            threads.emplace_back([&h, t]() {
+                for (uint64_t i = 0; i < 1000; i++) {
+                    h.Record(t * 1000 + i);
+                }
+            });
+        }
+    }
+    auto s = h.Summarize();
+    REQUIRE(s.count == 4000);
+    REQUIRE(s.max_ns == 3999);
+}
+
+TEST_CASE("Registry disabled") {
+    auto r = Registry();
+    auto calls = 0;
+    REQUIRE(r.Time(Probe::kFafAction, [&] { return ++calls; }) == 1);
+    r.Count(Counter::kCasts);
+
+    REQUIRE(r.histogram(Probe::kFafAction).Summarize().count == 0);
+    REQUIRE(r.count(Counter::kCasts) == 0);
+    REQUIRE(r.Report() == std::vector<std::string>{
+        "counters: lookups=0 mutex_waits=0 casts=0 aborted_casts=0"
+    });
+}
+
+TEST_CASE("Registry enabled") {
+    auto r = Registry();
+    r.SetEnabled(true);
+    r.Time(Probe::kConcInput, [] {});
+    r.Time(Probe::kConcInput, [] { std::this_thread::sleep_for(1ms); });
+    r.Count(Counter::kLookups);
+    r.Count(Counter::kAbortedCasts, 3);
+
+    auto s = r.histogram(Probe::kConcInput).Summarize();
+    REQUIRE(s.count == 2);
+    REQUIRE(s.max_ns >= 1'000'000);
+    REQUIRE(r.histogram(Probe::kFafAction).Summarize().count == 0);
+    REQUIRE(r.count(Counter::kLookups) == 1);
+    REQUIRE(r.count(Counter::kAbortedCasts) == 3);
+
+    auto report = r.Report();
+    REQUIRE(report.size() == 2);
+    REQUIRE(report[0].starts_with("conc_input: n=2 "));
+    REQUIRE(report[1] == "counters: lookups=1 mutex_waits=0 casts=0 aborted_casts=3");
+
+    r.Reset();
+    REQUIRE(r.Report().size() == 1);
+    REQUIRE(r.enabled());
+}
+
+TEST_CASE("PeriodicReporter") {
+    auto r = Registry();
+    r.SetEnabled(true);
+    r.Count(Counter::kCasts);
+
+    auto mutex = std::mutex();
+    auto reports = std::vector<std::vector<std::string>>();
+    auto done = std::binary_semaphore(0);
+    {
+        auto reporter = PeriodicReporter(r, 1ms, [&](const std::vector<std::string>& lines) {
+            auto lock = std::lock_guard(mutex);
+            reports.push_back(lines);
+            if (reports.size() == 2) {
+                done.release();
+            }
+        });
+        REQUIRE(done.try_acquire_for(10s));
+    }
+
+    // No more reports after destruction.
+    auto lock = std::lock_guard(mutex);
+    auto n = reports.size();
+    REQUIRE(n >= 2);
+    REQUIRE(reports[0].back() == "counters: lookups=0 mutex_waits=0 casts=1 aborted_casts=0");
+}
+
+}  // namespace metrics
+}  // namespace esas
@@ -1,4 +1,7 @@
 #pragma once
 
+#include "pch_core.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
@@ -0,0 +1,37 @@
+#include "periodic_thread.h"
+
+namespace esas {
+
+using namespace std::chrono_literals;
+
+TEST_CASE("PeriodicThread runs task repeatedly") {
+    auto calls = std::atomic<int>(0);
+    auto done = std::binary_semaphore(0);
+    auto n = 0;
+    {
+        auto thread = PeriodicThread(1ms, [&]() {
+            if (++calls == 3) {
+                done.release();
+            }
+        });
+        REQUIRE(done.try_acquire_for(10s));
+    }
+
+    // No more calls after destruction.
+    n = calls;
+    std::this_thread::sleep_for(10ms);
+    REQUIRE(calls == n);
+    REQUIRE(n >= 3);
+}
+
+TEST_CASE("PeriodicThread destruction doesn't wait out the interval") {
+    auto calls = std::atomic<int>(0);
+    auto start = std::chrono::steady_clock::now();
+    {
+        auto thread = PeriodicThread(1h, [&]() { calls++; });
+    }
+    REQUIRE(std::chrono::steady_clock::now() - start < 10s);
+    REQUIRE(calls == 0);
+}
+
+}  // namespace esas
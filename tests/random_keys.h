@@ -0,0 +1,48 @@
+#pragma once
+
+#include "keys.h"
+
+namespace esas {
+
+inline std::vector<uint32_t>
+ValidKeycodes() {
+    auto v = std::vector<uint32_t>();
+    for (uint32_t i = 0; i < kKeycodeNames.size(); i++) {
+        if (KeycodeIsValid(i)) {
+            v.push_back(i);
+        }
+    }
+    return v;
+}
+
+/// Keysets drawn from `pool` so that matches are neither guaranteed nor hopeless.
+inline Keysets
+RandomKeysets(std::mt19937& rng, std::span<const uint32_t> pool, size_t n) {
+    auto v = std::vector<Keyset>();
+    for (size_t i = 0; i < n; i++) {
+        auto keyset = Keyset();
+        auto sz = rng() % 4 + 1;
+        for (size_t j = 0; j < sz; j++) {
+            keyset[j] = pool[rng() % pool.size()];
+        }
+        v.push_back(keyset);
+    }
+    return Keysets(std::move(v));
+}
+
+/// A burst of distinct keystrokes drawn from `pool`.
+inline std::vector<Keystroke>
+RandomKeystrokes(std::mt19937& rng, std::span<const uint32_t> pool, size_t n) {
+    auto keycodes = std::vector<uint32_t>(pool.begin(), pool.end());
+    std::shuffle(keycodes.begin(), keycodes.end(), rng);
+    keycodes.resize(std::min(n, keycodes.size()));
+
+    auto v = std::vector<Keystroke>();
+    for (auto keycode : keycodes) {
+        auto heldsecs = rng() % 3 == 0 ? 0.f : static_cast<float>(rng() % 100) / 100.f;
+        v.push_back(*Keystroke::New(keycode, heldsecs));
+    }
+    return v;
+}
+
+}  // namespace esas
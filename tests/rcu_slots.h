@@ -0,0 +1,112 @@
+#pragma once
+
+#include "rcu.h"
+
+namespace esas {
+
+/// Slot table standing in for a shoutmap. Every slot of a consistent snapshot stores a value
+/// derived from `version`, so a torn or freed snapshot is detectable.
+struct Slots {
+    static constexpr size_t kSize = 64;
+
+    uint64_t version = 0;
+    std::array<uint64_t, kSize> spells{};
+    uint64_t checksum = 0;
+
+    static uint64_t
+    Spell(uint64_t version, size_t i) {
+        return version * kSize + i + 1;
+    }
+
+    uint64_t
+    Checksum() const {
+        return std::accumulate(spells.cbegin(), spells.cend(), version * 31);
+    }
+
+    bool
+    Consistent() const {
+        return Checksum() == checksum;
+    }
+};
+
+/// Writer that assigns, unassigns and reverts slots, publishing after every change.
+class SlotsWriter {
+  public:
+    explicit SlotsWriter(Rcu<Slots>& rcu) : rcu_(rcu) {}
+
+    void
+    Step(std::mt19937& rng) {
+        auto i = rng() % Slots::kSize;
+        cur_.version++;
+        switch (rng() % 8) {
+            case 0:  // revert
+                cur_.spells.fill(0);
+                break;
+            case 1:
+            case 2:  // unassign
+                cur_.spells[i] = 0;
+                break;
+            default:  // assign
+                cur_.spells[i] = Slots::Spell(cur_.version, i);
+                break;
+        }
+        cur_.checksum = cur_.Checksum();
+        rcu_.Publish(std::make_unique<const Slots>(cur_));
+    }
+
+  private:
+    Rcu<Slots>& rcu_;
+    Slots cur_;
+};
+
+struct ReaderStats {
+    uint64_t reads = 0;
+    uint64_t torn = 0;
+    uint64_t regressions = 0;
+    std::vector<uint32_t> latencies_ns;
+};
+
+/// Runs `nreaders` reader threads while the calling thread performs `nwrites` writes.
+inline std::vector<ReaderStats>
+Hammer(Rcu<Slots>& rcu, size_t nreaders, size_t nwrites, bool record_latency) {
+    auto stop = std::atomic<bool>(false);
+    auto stats = std::vector<ReaderStats>(nreaders);
+    auto start = std::latch(static_cast<ptrdiff_t>(nreaders + 1));
+    auto threads = std::vector<std::jthread>();
+
+    for (size_t t = 0; t < nreaders; t++) {
+        threads.emplace_back([&, t]() {
+            auto& st = stats[t];
+            auto last_version = uint64_t(0);
+            start.arrive_and_wait();
+            while (!stop.load(std::memory_order_relaxed)) {
+                auto t0 = std::chrono::steady_clock::now();
+                auto snap = rcu.Read();
+                auto consistent = snap->Consistent();
+                auto version = snap->version;
+                auto t1 = std::chrono::steady_clock::now();
+
+                st.reads++;
+                st.torn += !consistent;
+                st.regressions += version < last_version;
+                last_version = version;
+                if (record_latency && st.latencies_ns.size() < 1'000'000) {
+                    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0);
+                    st.latencies_ns.push_back(static_cast<uint32_t>(ns.count()));
+                }
+            }
+        });
+    }
+
+    auto writer = SlotsWriter(rcu);
+    auto rng = std::mt19937(42);
+    start.arrive_and_wait();
+    for (size_t i = 0; i < nwrites; i++) {
+        writer.Step(rng);
+    }
+    stop = true;
+    threads.clear();
+    return stats;
+}
+
+}  // namespace esas
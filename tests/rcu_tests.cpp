@@ -0,0 +1,39 @@
+#include "rcu.h"
+#include "rcu_slots.h"
+
+namespace esas {
+
+TEST_CASE("Rcu publish and read") {
+    auto rcu = Rcu<std::string>();
+    REQUIRE(*rcu.Read() == "");
+
+    rcu.Publish(std::make_unique<const std::string>("a"));
+    {
+        auto s = rcu.Read();
+        REQUIRE(*s == "a");
+
+        // The guard keeps "a" alive across a publish.
+        rcu.Publish(std::make_unique<const std::string>("b"));
+        REQUIRE(*s == "a");
+        REQUIRE(rcu.Reclaim() == 1);
+    }
+    REQUIRE(rcu.Reclaim() == 0);
+    REQUIRE(*rcu.Read() == "b");
+}
+
+TEST_CASE("Rcu readers never observe torn snapshots") {
+    auto rcu = Rcu<Slots>();
+    auto stats = Hammer(rcu, 4, 20000, /*record_latency=*/false);
+
+    uint64_t reads = 0;
+    for (const auto& st : stats) {
+        reads += st.reads;
+        REQUIRE(st.torn == 0);
+        REQUIRE(st.regressions == 0);
+    }
+    REQUIRE(reads > 0);
+    REQUIRE(rcu.Reclaim() == 0);
+    REQUIRE(rcu.Read()->Consistent());
+}
+
+}  // namespace esas
@@ -0,0 +1,130 @@
+#include "record_stream.h"
+#include "cosave.h"
+#include "fake_serialization.h"
+
+namespace esas {
+namespace {
+
+std::vector<std::byte>
+Bytes(size_t n) {
+    auto v = std::vector<std::byte>(n);
+    for (size_t i = 0; i < n; i++) {
+        v[i] = static_cast<std::byte>(i * 7);
+    }
+    return v;
+}
+
+}  // namespace
+
+TEST_CASE("RecordWriter/RecordReader round trip") {
+    auto si = FakeSerialization();
+    auto a = Bytes(10);
+    auto b = Bytes(1000);
+    {
+        auto w = RecordWriter(si, RecordType("AAAA"), 1);
+        REQUIRE(w.Write(std::span(a).first(4)));
+        REQUIRE(w.Write(std::span(a).subspan(4)));
+    }
+    {
+        auto w = RecordWriter(si, RecordType("BBBB"), 2);
+        REQUIRE(w.Write(b));
+    }
+    si.Rewind();
+
+    auto buf = std::vector<std::byte>();
+    uint32_t type = 0;
+    uint32_t version = 0;
+    uint32_t length = 0;
+
+    REQUIRE(si.GetNextRecordInfo(type, version, length));
+    REQUIRE(type == RecordType("AAAA"));
+    REQUIRE(version == 1);
+    auto got_a = RecordReader(si, length, buf).ReadAll();
+    REQUIRE(got_a);
+    REQUIRE(std::ranges::equal(*got_a, a));
+
+    REQUIRE(si.GetNextRecordInfo(type, version, length));
+    REQUIRE(type == RecordType("BBBB"));
+    si.read_calls = 0;
+    auto got_b = RecordReader(si, length, buf, /*chunk_size=*/256).ReadAll();
+    REQUIRE(got_b);
+    REQUIRE(std::ranges::equal(*got_b, b));
+    REQUIRE(si.read_calls == 4);
+
+    REQUIRE(!si.GetNextRecordInfo(type, version, length));
+}
+
+TEST_CASE("RecordReader is bounded by record length") {
+    auto si = FakeSerialization();
+    REQUIRE(RecordWriter(si, RecordType("AAAA"), 1).Write(Bytes(10)));
+    si.Rewind();
+
+    uint32_t type = 0;
+    uint32_t version = 0;
+    uint32_t length = 0;
+    REQUIRE(si.GetNextRecordInfo(type, version, length));
+    auto buf = std::vector<std::byte>();
+    auto r = RecordReader(si, length, buf);
+
+    auto dst = std::array<std::byte, 6>();
+    REQUIRE(r.Read(dst) == 6);
+    REQUIRE(r.remaining() == 4);
+    REQUIRE(r.Read(dst) == 4);
+    REQUIRE(r.remaining() == 0);
+    REQUIRE(r.Read(dst) == 0);
+}
+
+TEST_CASE("RecordReader short read") {
+    auto si = FakeSerialization();
+    REQUIRE(RecordWriter(si, RecordType("AAAA"), 1).Write(Bytes(10)));
+    si.Rewind();
+
+    uint32_t type = 0;
+    uint32_t version = 0;
+    uint32_t length = 0;
+    REQUIRE(si.GetNextRecordInfo(type, version, length));
+    auto buf = std::vector<std::byte>();
+    // Claim a longer record than actually exists.
+    REQUIRE(!RecordReader(si, length + 1, buf).ReadAll());
+}
+
+TEST_CASE("cosave save/load through serialization interface") {
+    auto si = FakeSerialization();
+    si.form_id_remap = {
+        {0x0a000d62, 0x0b000d62},  // mod moved in load order
+        {0x00012fcd, 0x00012fcd},
+    };
+    auto buf = std::vector<std::byte>();
+
+    // Another plugin's record type.
+    REQUIRE(RecordWriter(si, RecordType("XXXX"), 1).Write(Bytes(3)));
+    auto ir = ShoutmapIR{{0x900, 0x0a000d62}, {0x901, 0x0c000001}, {0x902, 0x00012fcd}};
+    REQUIRE(cosave::SaveShoutmapIR(si, ir, buf));
+    REQUIRE(si.write_calls == 2);
+
+    // Legacy JSON record from before the binary format.
+    auto json = std::string_view("[[2307,77773]]");
+    REQUIRE(RecordWriter(si, cosave::kRecordType, cosave::kVersionJson)
+                .Write(std::as_bytes(std::span(json.data(), json.size()))));
+    si.form_id_remap[77773] = 77773;
+
+    si.Rewind();
+    auto got = cosave::LoadShoutmapIR(si, buf);
+    auto want = ShoutmapIR{{0x900, 0x0b000d62}, {0x902, 0x00012fcd}, {0x903, 77773}};
+    REQUIRE(got == want);
+}
+
+TEST_CASE("cosave load skips corrupt records") {
+    auto si = FakeSerialization();
+    si.form_id_remap = {{1, 1}, {2, 2}};
+    auto buf = std::vector<std::byte>();
+
+    REQUIRE(cosave::SaveShoutmapIR(si, {{0x900, 1}}, buf));
+    si.records.back().data.back() ^= std::byte(1);
+    REQUIRE(cosave::SaveShoutmapIR(si, {{0x901, 2}}, buf));
+
+    si.Rewind();
+    REQUIRE(cosave::LoadShoutmapIR(si, buf) == ShoutmapIR{{0x901, 2}});
+}
+
+}  // namespace esas
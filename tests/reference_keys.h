@@ -0,0 +1,44 @@
+#pragma once
+
+#include "keys.h"
+
+namespace esas {
+
+/// Reference matcher: scans `keystrokes` once per keycode per keyset.
+inline Keypress
+MatchLinear(const Keysets& keysets, std::span<const Keystroke> keystrokes) {
+    for (const auto& keyset : keysets.vec()) {
+        auto min_heldsecs = std::numeric_limits<float>::infinity();
+        auto matched = true;
+        for (auto keycode : keyset) {
+            if (!KeycodeIsValid(keycode)) {
+                break;
+            }
+            auto it = std::find_if(keystrokes.begin(), keystrokes.end(), [=](const Keystroke& ks) {
+                return ks.keycode() == keycode;
+            });
+            if (it == keystrokes.end()) {
+                matched = false;
+                break;
+            }
+            min_heldsecs = std::min(min_heldsecs, it->heldsecs());
+        }
+        if (matched) {
+            return KeypressFromHeldsecs(min_heldsecs);
+        }
+    }
+    return Keypress::kNone;
+}
+
+/// Reference lookup: the linear scan that the perfect hash replaced.
+constexpr uint32_t
+KeycodeFromNameLinear(std::string_view name) {
+    for (uint32_t i = 0; i < kKeycodeNames.size(); i++) {
+        if (name == kKeycodeNames[i]) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+}  // namespace esas
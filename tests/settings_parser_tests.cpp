@@ -0,0 +1,161 @@
+#include "settings_parser.h"
+#include "serde.h"
+
+namespace esas {
+namespace {
+
+void
+RequireSameSettings(const Settings& a, const Settings& b) {
+    REQUIRE(a.log_level == b.log_level);
+    REQUIRE(a.log_async == b.log_async);
+    REQUIRE(a.convert_spell_keysets.vec() == b.convert_spell_keysets.vec());
+    REQUIRE(a.remove_shout_keysets.vec() == b.remove_shout_keysets.vec());
+    REQUIRE(a.save_loadout_keysets.vec() == b.save_loadout_keysets.vec());
+    REQUIRE(a.apply_loadout_keysets.vec() == b.apply_loadout_keysets.vec());
+    REQUIRE(a.allow_2h_spells == b.allow_2h_spells);
+    REQUIRE(a.console_shout_commands == b.console_shout_commands);
+    REQUIRE(a.magicka_scale_faf == b.magicka_scale_faf);
+    REQUIRE(a.magicka_scale_conc == b.magicka_scale_conc);
+    REQUIRE(a.metrics_interval_secs == b.metrics_interval_secs);
+    REQUIRE(a.settings_reload_secs == b.settings_reload_secs);
+}
+
+/// Parses `json` both ways, requires the same outcome, and returns it.
+std::optional<Settings>
+ParseBothWays(std::string_view json) {
+    auto got = ParseSettings(json);
+    auto want = Deserialize<Settings>(json);
+    REQUIRE(got.has_value() == want.has_value());
+    if (got) {
+        RequireSameSettings(*got, *want);
+    }
+    return got;
+}
+
+Keyset
+KeysetFromNames(std::string_view a, std::string_view b) {
+    return KeysetNormalized({KeycodeFromName(a), KeycodeFromName(b)});
+}
+
+}  // namespace
+
+TEST_CASE("ParseSettings all fields") {
+    auto settings = ParseBothWays(R"({
+        // Comments and trailing commas are allowed.
+        "log_level": "debug",
+        "log_async": true,
+        "convert_spell_keysets": [["LShift", "="], ["RShift", "="],],
+        "remove_shout_keysets": [["LShift", "-"]],
+        "save_loadout_keysets": [["LShift", "["]],
+        "apply_loadout_keysets": [["LShift", "]"]],
+        "allow_2h_spells": true,
+        "console_shout_commands": true,
+        "magicka_scale_faf": 0.5,
+        "magicka_scale_conc": 2,
+        "metrics_interval_secs": 10,
+        "settings_reload_secs": 1.5,
+    })");
+    REQUIRE(settings);
+    REQUIRE(settings->log_level == "debug");
+    REQUIRE(settings->log_async);
+    REQUIRE(
+        settings->convert_spell_keysets.vec()
+        == std::vector{KeysetFromNames("LShift", "="), KeysetFromNames("RShift", "=")}
+    );
+    REQUIRE(settings->remove_shout_keysets.vec() == std::vector{KeysetFromNames("LShift", "-")});
+    REQUIRE(settings->save_loadout_keysets.vec() == std::vector{KeysetFromNames("LShift", "[")});
+    REQUIRE(settings->apply_loadout_keysets.vec() == std::vector{KeysetFromNames("LShift", "]")});
+    REQUIRE(settings->allow_2h_spells);
+    REQUIRE(settings->console_shout_commands);
+    REQUIRE(settings->magicka_scale_faf == .5f);
+    REQUIRE(settings->magicka_scale_conc == 2.f);
+    REQUIRE(settings->metrics_interval_secs == 10.f);
+    REQUIRE(settings->settings_reload_secs == 1.5f);
+}
+
+TEST_CASE("ParseSettings ignores what Deserialize ignores") {
+    auto defaults = Settings();
+
+    SECTION("non-object documents") {
+        for (auto json : {"[]", R"(["log_level", "debug"])", R"("debug")", "1", "null"}) {
+            auto settings = ParseBothWays(json);
+            REQUIRE(settings);
+            RequireSameSettings(*settings, defaults);
+        }
+    }
+
+    SECTION("wrong types") {
+        auto settings = ParseBothWays(R"({
+            "log_level": 5,
+            "log_async": "true",
+            "convert_spell_keysets": ["LShift", "="],
+            "remove_shout_keysets": {"keys": [["LShift", "-"]]},
+            "allow_2h_spells": 1,
+            "magicka_scale_faf": "0.5",
+            "magicka_scale_conc": null,
+            "metrics_interval_secs": [10],
+        })");
+        REQUIRE(settings);
+        REQUIRE(settings->log_level == defaults.log_level);
+        REQUIRE(!settings->log_async);
+        REQUIRE(settings->convert_spell_keysets.vec().empty());
+        REQUIRE(settings->remove_shout_keysets.vec() == defaults.remove_shout_keysets.vec());
+        REQUIRE(!settings->allow_2h_spells);
+        REQUIRE(settings->magicka_scale_faf == defaults.magicka_scale_faf);
+        REQUIRE(settings->magicka_scale_conc == defaults.magicka_scale_conc);
+        REQUIRE(settings->metrics_interval_secs == defaults.metrics_interval_secs);
+    }
+
+    SECTION("unknown and nested fields") {
+        auto settings = ParseBothWays(R"({
+            "unknown": {"log_level": "trace", "allow_2h_spells": true},
+            "also_unknown": [{"convert_spell_keysets": [["LShift", "A"]]}],
+            "log_level": "warn",
+        })");
+        REQUIRE(settings);
+        REQUIRE(settings->log_level == "warn");
+        REQUIRE(!settings->allow_2h_spells);
+        REQUIRE(settings->convert_spell_keysets.vec() == defaults.convert_spell_keysets.vec());
+    }
+
+    SECTION("malformed keysets") {
+        auto settings = ParseBothWays(R"({
+            "convert_spell_keysets": [
+                ["LShift", 5],
+                "RShift",
+                [],
+                [["LShift"], "="],
+                {"keys": ["LShift", "="]},
+                ["NotAKey", "LeftShift", "Minus"],
+                ["A", "B", "C", "D", "E"],
+            ],
+        })");
+        REQUIRE(settings);
+        REQUIRE(
+            settings->convert_spell_keysets.vec()
+            == std::vector{
+                KeysetFromNames("LShift", "-"),
+                KeysetNormalized(
+                    {KeycodeFromName("A"),
+                     KeycodeFromName("B"),
+                     KeycodeFromName("C"),
+                     KeycodeFromName("D")}
+                ),
+            }
+        );
+    }
+
+    SECTION("escaped strings") {
+        auto settings = ParseBothWays(R"({"log_level": "in\/fo"})");
+        REQUIRE(settings);
+        REQUIRE(settings->log_level == "in/fo");
+    }
+}
+
+TEST_CASE("ParseSettings rejects invalid JSON") {
+    for (auto json : {"", "{", R"({"log_level": )", R"({"log_level": "info"} extra)", "[1 2]"}) {
+        REQUIRE(!ParseBothWays(json));
+    }
+}
+
+}  // namespace esas
@@ -0,0 +1,168 @@
+#include "settings_watcher.h"
+#include "test_util.h"
+
+namespace esas {
+namespace {
+
+/// Settings in which every field is derived from `version`, so a mix of two versions is detectable.
+std::string
+VersionedSettingsJson(uint32_t version) {
+    return std::format(
+        R"({{
+            "log_level": "v{0}",
+            "allow_2h_spells": {1},
+            "console_shout_commands": {1},
+            "magicka_scale_faf": {0},
+            "magicka_scale_conc": {0},
+        }})",
+        version,
+        version % 2 == 1
+    );
+}
+
+/// Returns nullopt if `settings` did not come from a single `VersionedSettingsJson()`.
+std::optional<uint32_t>
+SettingsVersion(const Settings& settings) {
+    if (!settings.log_level.starts_with("v")) {
+        return std::nullopt;
+    }
+    auto version = uint32_t(0);
+    auto sv = std::string_view(settings.log_level).substr(1);
+    if (std::from_chars(sv.data(), sv.data() + sv.size(), version).ec != std::errc()) {
+        return std::nullopt;
+    }
+    auto odd = version % 2 == 1;
+    if (settings.allow_2h_spells != odd || settings.console_shout_commands != odd
+        || settings.magicka_scale_faf != static_cast<float>(version)
+        || settings.magicka_scale_conc != static_cast<float>(version)) {
+        return std::nullopt;
+    }
+    return version;
+}
+
+/// Writes `contents` and gives the file a modification time unique to `version`, so that the
+/// change is visible even on filesystems with coarse timestamps.
+void
+WriteVersion(const std::string& path, uint32_t version, std::string_view contents) {
+    REQUIRE(fs::WriteFile(path, contents));
+    auto mtime = std::filesystem::file_time_type() + std::chrono::seconds(1'000'000 + version);
+    std::filesystem::last_write_time(path, mtime);
+}
+
+}  // namespace
+
+TEST_CASE("SettingsWatcher reloads on change") {
+    auto td = Tempdir();
+    auto path = td.path() + "/settings.json";
+    WriteVersion(path, 1, VersionedSettingsJson(1));
+
+    auto rcu = Rcu<Settings>();
+    auto reloads = std::vector<uint32_t>();
+    auto watcher = SettingsWatcher(path, rcu, [&](const Settings& settings) {
+        reloads.push_back(SettingsVersion(settings).value_or(0));
+    });
+
+    // The file as it was at construction is assumed to be loaded already.
+    REQUIRE(!watcher.Poll());
+    REQUIRE(rcu.Read()->log_level == Settings().log_level);
+
+    WriteVersion(path, 2, VersionedSettingsJson(2));
+    REQUIRE(watcher.Poll());
+    REQUIRE(SettingsVersion(*rcu.Read()) == 2);
+    REQUIRE(!watcher.Poll());
+
+    // Unparseable files are skipped.
+    WriteVersion(path, 3, R"({"log_level": )");
+    REQUIRE(!watcher.Poll());
+    REQUIRE(SettingsVersion(*rcu.Read()) == 2);
+
+    REQUIRE(fs::RemoveFile(path));
+    REQUIRE(!watcher.Poll());
+    REQUIRE(SettingsVersion(*rcu.Read()) == 2);
+
+    WriteVersion(path, 4, VersionedSettingsJson(4));
+    REQUIRE(watcher.Poll());
+    REQUIRE(SettingsVersion(*rcu.Read()) == 4);
+
+    // A file that fails to parse is retried, even if the next write leaves the modification time
+    // and size unchanged.
+    auto json = VersionedSettingsJson(5);
+    auto broken = json;
+    broken.back() = ' ';
+    WriteVersion(path, 5, broken);
+    REQUIRE(!watcher.Poll());
+    REQUIRE(!watcher.Poll());
+    WriteVersion(path, 5, json);
+    REQUIRE(watcher.Poll());
+    REQUIRE(SettingsVersion(*rcu.Read()) == 5);
+
+    REQUIRE(reloads == std::vector<uint32_t>{2, 4, 5});
+}
+
+TEST_CASE("SettingsWatcher readers never observe half-applied settings") {
+    auto td = Tempdir();
+    auto path = td.path() + "/settings.json";
+    auto rcu = Rcu<Settings>(
+        std::make_unique<const Settings>(*ParseSettings(VersionedSettingsJson(0)))
+    );
+    auto watcher = SettingsWatcher(path, rcu);
+
+    constexpr size_t kReaders = 4;
+    constexpr uint32_t kVersions = 200;
+    auto stop = std::atomic<bool>(false);
+    auto reads = std::array<uint64_t, kReaders>{};
+    auto torn = std::array<uint64_t, kReaders>{};
+    auto regressions = std::array<uint64_t, kReaders>{};
+    auto start = std::latch(kReaders + 1);
+    auto readers = std::vector<std::jthread>();
+    for (size_t t = 0; t < kReaders; t++) {
+        readers.emplace_back([&, t]() {
+            auto last = uint32_t(0);
+            start.arrive_and_wait();
+            while (!stop.load(std::memory_order_relaxed)) {
+                auto settings = rcu.Read();
+                auto version = SettingsVersion(*settings);
+                reads[t]++;
+                torn[t] += !version;
+                regressions[t] += version && *version < last;
+                last = version.value_or(last);
+            }
+        });
+    }
+
+    start.arrive_and_wait();
+    for (uint32_t v = 1; v <= kVersions; v++) {
+        WriteVersion(path, v, VersionedSettingsJson(v));
+        REQUIRE(watcher.Poll());
+    }
+    stop = true;
+    readers.clear();
+
+    for (size_t t = 0; t < kReaders; t++) {
+        REQUIRE(reads[t] > 0);
+        REQUIRE(torn[t] == 0);
+        REQUIRE(regressions[t] == 0);
+    }
+    REQUIRE(SettingsVersion(*rcu.Read()) == kVersions);
+    REQUIRE(rcu.Reclaim() == 0);
+}
+
+TEST_CASE("SettingsWatcher polls from background thread") {
+    auto td = Tempdir();
+    auto path = td.path() + "/settings.json";
+    auto rcu = Rcu<Settings>();
+    auto reloaded = std::atomic<bool>(false);
+    auto watcher = SettingsWatcher(path, rcu, std::chrono::milliseconds(5), [&](const Settings&) {
+        reloaded = true;
+    });
+
+    WriteVersion(path, 7, VersionedSettingsJson(7));
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (SettingsVersion(*rcu.Read()) != 7 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    REQUIRE(SettingsVersion(*rcu.Read()) == 7);
+    REQUIRE(reloaded);
+}
+
+}  // namespace esas
@@ -0,0 +1,27 @@
+#include "shout_set.h"
+#include "fake_forms.h"
+
+namespace esas {
+
+static_assert(ShoutHolder<ShoutSet, FakeShout>);
+
+TEST_CASE("ShoutSet") {
+    auto shouts = FakeForms<FakeShout>(0x900, 4);
+
+    auto empty = ShoutSet();
+    REQUIRE(empty.size() == 0);
+    REQUIRE(!empty.HasShout(&shouts[0]));
+
+    auto owned = std::vector<const FakeShout*>{&shouts[3], nullptr, &shouts[1], &shouts[3]};
+    auto set = ShoutSet(owned);
+    REQUIRE(set.size() == 2);
+    REQUIRE(!set.HasShout(&shouts[0]));
+    REQUIRE(set.HasShout(&shouts[1]));
+    REQUIRE(!set.HasShout(&shouts[2]));
+    REQUIRE(set.HasShout(&shouts[3]));
+    REQUIRE(!set.HasShout(static_cast<const FakeShout*>(nullptr)));
+    REQUIRE(set.Contains(0x901));
+    REQUIRE(!set.Contains(0));
+}
+
+}  // namespace esas
@@ -0,0 +1,147 @@
+#include "shout_slots.h"
+#include "cast_profile.h"
+#include "fake_forms.h"
+
+namespace esas {
+
+using FakeSlots = ShoutSlots<FakeShout, FakeSpell>;
+
+TEST_CASE("ShoutSlots set/lookup") {
+    auto shouts = FakeForms<FakeShout>(0x900, 3);
+    auto spells = FakeForms<FakeSpell>(0x1000, 3);
+    auto slots = FakeSlots(shouts.ptrs());
+    REQUIRE(slots.size() == 3);
+    REQUIRE(slots.IndexOf(shouts[1]) == 1);
+    REQUIRE(slots.IndexOf(spells[0]) >= slots.size());
+
+    // Same form ID, different object.
+    auto impostor = FakeShout();
+    impostor.id = 0x900;
+    REQUIRE(slots.IndexOf(impostor) >= slots.size());
+
+    slots.Set(1, &spells[0]);
+    REQUIRE(slots.spells()[1] == &spells[0]);
+    REQUIRE(slots.IndexOf(spells[0]) == 1);
+
+    slots.Set(1, &spells[2]);
+    REQUIRE(slots.IndexOf(spells[0]) >= slots.size());
+    REQUIRE(slots.IndexOf(spells[2]) == 1);
+
+    slots.Set(1, nullptr);
+    REQUIRE(slots.spells()[1] == nullptr);
+    REQUIRE(slots.IndexOf(spells[2]) >= slots.size());
+}
+
+TEST_CASE("ShoutSlots spell in multiple slots") {
+    auto shouts = FakeForms<FakeShout>(0x900, 4);
+    auto spells = FakeForms<FakeSpell>(0x1000, 1);
+    auto slots = FakeSlots(shouts.ptrs());
+
+    slots.Set(2, &spells[0]);
+    slots.Set(1, &spells[0]);
+    slots.Set(3, &spells[0]);
+    REQUIRE(slots.IndexOf(spells[0]) == 1);
+
+    slots.Set(1, nullptr);
+    REQUIRE(slots.IndexOf(spells[0]) == 2);
+    slots.Set(2, nullptr);
+    REQUIRE(slots.IndexOf(spells[0]) == 3);
+    slots.Set(3, nullptr);
+    REQUIRE(slots.IndexOf(spells[0]) >= slots.size());
+}
+
+TEST_CASE("ShoutSlots next unassigned") {
+    auto shouts = FakeForms<FakeShout>(0x900, 3);
+    auto spells = FakeForms<FakeSpell>(0x1000, 3);
+    auto slots = FakeSlots(shouts.ptrs());
+    auto player = FakeActor();
+
+    REQUIRE(slots.NextUnassigned() == 0);
+
+    slots.Set(0, &spells[0]);
+    player.shouts.insert(&shouts[0]);
+    slots.RefreshOwned(player.shouts);
+    REQUIRE(slots.NextUnassigned() == 1);
+
+    // Assigned, but the player lost the shout, so it's free again and takes priority.
+    slots.Set(2, &spells[2]);
+    REQUIRE(slots.NextUnassigned() == 2);
+
+    slots.Set(1, &spells[1]);
+    player.shouts.insert(&shouts[1]);
+    player.shouts.insert(&shouts[2]);
+    slots.RefreshOwned(player.shouts);
+    REQUIRE(slots.NextUnassigned() >= slots.size());
+
+    // Refreshing forgets shouts that the player no longer has, and ignores unknown shouts.
+    auto stranger = FakeShout();
+    stranger.id = 0x800;
+    slots.RefreshOwned(std::vector<const FakeShout*>{&shouts[0], &stranger, nullptr});
+    REQUIRE(slots.NextUnassigned() == 1);
+    slots.SetOwned(1, true);
+    REQUIRE(slots.NextUnassigned() == 2);
+}
+
+TEST_CASE("ShoutSlots add") {
+    auto shouts = FakeForms<FakeShout>(0x900, 130);
+    auto spells = FakeForms<FakeSpell>(0x1000, 130);
+    auto slots = FakeSlots();
+    REQUIRE(slots.NextUnassigned() >= slots.size());
+
+    for (size_t i = 0; i < 130; i++) {
+        slots.Add(&shouts[i]);
+        REQUIRE(slots.size() == i + 1);
+        REQUIRE(slots.IndexOf(shouts[i]) == i);
+        REQUIRE(slots.NextUnassigned() == i);
+        slots.Set(i, &spells[i]);
+        slots.SetOwned(i, true);
+    }
+    REQUIRE(slots.NextUnassigned() >= slots.size());
+    REQUIRE(slots.IndexOf(spells[129]) == 129);
+
+    slots.Set(100, nullptr);
+    slots.Set(70, nullptr);
+    REQUIRE(slots.NextUnassigned() == 70);
+    slots.Set(70, &spells[70]);
+    REQUIRE(slots.NextUnassigned() == 100);
+}
+
+TEST_CASE("ShoutSlots profiles") {
+    using Profile = CastProfile<FakeSound>;
+    auto shouts = FakeForms<FakeShout>(0x900, 3);
+    auto spells = FakeForms<FakeSpell>(0x1000, 2);
+    auto sounds = FakeForms<FakeSound>(0x2000, 2);
+    auto slots = ShoutSlots<FakeShout, FakeSpell, Profile>({&shouts[0], &shouts[1]});
+    REQUIRE(slots.profile(0) == Profile());
+
+    auto flames = Profile{
+        .casting_type = CastingType::kConcentration,
+        .release_sound = &sounds[0],
+        .loop_sound = &sounds[1],
+    };
+    auto bound_sword = Profile{
+        .casting_type = CastingType::kFireAndForget,
+        .bound_weapon = true,
+        .release_sound = &sounds[0],
+    };
+
+    slots.Set(0, &spells[0], flames);
+    REQUIRE(slots.profile(0) == flames);
+    REQUIRE(slots.profile(1) == Profile());
+
+    // Reassigning replaces the profile, even if the spell is unchanged (e.g. it was edited).
+    slots.Set(0, &spells[1], bound_sword);
+    REQUIRE(slots.profile(0) == bound_sword);
+    flames.loop_sound = nullptr;
+    slots.Set(0, &spells[1], flames);
+    REQUIRE(slots.profile(0) == flames);
+
+    // Unassigning clears the profile.
+    slots.Set(0, nullptr, bound_sword);
+    REQUIRE(slots.profile(0) == Profile());
+
+    slots.Add(&shouts[2]);
+    REQUIRE(slots.profile(2) == Profile());
+}
+
+}  // namespace esas
@@ -0,0 +1,99 @@
+#include "slot_allocator.h"
+
+namespace esas {
+namespace {
+
+/// What `SlotAllocator::Next()` replaces: a scan over every slot.
+size_t
+NextLinear(const SlotAllocator& alloc) {
+    for (size_t i = 0; i < alloc.size(); i++) {
+        if (alloc.assigned(i) && !alloc.owned(i)) {
+            return i;
+        }
+    }
+    for (size_t i = 0; i < alloc.size(); i++) {
+        if (!alloc.assigned(i)) {
+            return i;
+        }
+    }
+    return alloc.size();
+}
+
+}  // namespace
+
+TEST_CASE("SlotAllocator basics") {
+    auto alloc = SlotAllocator();
+    REQUIRE(alloc.size() == 0);
+    REQUIRE(alloc.Next() >= alloc.size());
+
+    alloc = SlotAllocator(3);
+    REQUIRE(alloc.Next() == 0);
+
+    alloc.SetAssigned(0, true);
+    alloc.SetOwned(0, true);
+    REQUIRE(alloc.Next() == 1);
+
+    // Unassigned but owned slots still count as free.
+    alloc.SetOwned(1, true);
+    REQUIRE(alloc.Next() == 1);
+
+    // Assigned but unowned slots take priority.
+    alloc.SetAssigned(2, true);
+    REQUIRE(alloc.Next() == 2);
+
+    alloc.SetAssigned(1, true);
+    alloc.SetOwned(2, true);
+    REQUIRE(alloc.Next() >= alloc.size());
+
+    alloc.ClearOwned();
+    REQUIRE(!alloc.owned(0));
+    REQUIRE(alloc.Next() == 0);
+}
+
+TEST_CASE("SlotAllocator word boundaries") {
+    auto n = GENERATE(63u, 64u, 65u, 128u, 200u);
+    auto alloc = SlotAllocator(n);
+    for (size_t i = 0; i < n; i++) {
+        alloc.SetAssigned(i, true);
+        alloc.SetOwned(i, true);
+    }
+    REQUIRE(alloc.Next() >= alloc.size());
+
+    // Padding bits past the last slot never count as unassigned.
+    alloc.Add();
+    REQUIRE(alloc.Next() == n);
+    alloc.SetAssigned(n, true);
+    alloc.SetOwned(n, true);
+    REQUIRE(alloc.Next() >= alloc.size());
+
+    alloc.SetOwned(n - 1, false);
+    REQUIRE(alloc.Next() == n - 1);
+}
+
+TEST_CASE("SlotAllocator agrees with linear scan") {
+    auto n = GENERATE(1u, 30u, 64u, 100u, 512u);
+    auto rng = std::mt19937(n);
+    auto alloc = SlotAllocator(n);
+
+    for (size_t op = 0; op < 2000; op++) {
+        auto i = rng() % n;
+        switch (rng() % 5) {
+            case 0:
+            case 1:
+                alloc.SetAssigned(i, rng() % 2);
+                break;
+            case 2:
+            case 3:
+                alloc.SetOwned(i, rng() % 4 != 0);
+                break;
+            case 4:
+                if (rng() % 50 == 0) {
+                    alloc.ClearOwned();
+                }
+                break;
+        }
+        REQUIRE(alloc.Next() == NextLinear(alloc));
+    }
+}
+
+}  // namespace esas